@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <utility>
+#include <vle/manager/PreparedSimulation.hpp>
 #include <vle/manager/Simulation.hpp>
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/Package.hpp>
@@ -40,21 +41,40 @@
 #define OMPI_SKIP_MPICXX
 #include <mpi.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <locale>
+#include <mutex>
 #include <sstream>
 #include <stack>
+#include <thread>
 
 #include <cassert>
 #include <cerrno>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <getopt.h>
 
+#ifndef _WIN32
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #ifdef VLE_HAVE_NLS
 #ifndef ENABLE_NLS
 #define ENABLE_NLS
@@ -138,43 +158,6 @@ mpi_recv_string()
     return std::make_tuple(ret, status.MPI_SOURCE, from_int(status.MPI_TAG));
 }
 
-static void
-mpi_send_block(int target,
-               CommunicationTag tag,
-               const std::string& block,
-               int first,
-               int last)
-{
-    std::array<int, 2> ids{ { first, last } };
-
-    if (MPI_Send(block.data(),
-                 static_cast<int>(block.size()),
-                 MPI_CHAR,
-                 target,
-                 tag,
-                 MPI_COMM_WORLD) != MPI_SUCCESS) {
-        fprintf(stderr,
-                "Sending block buffer (size: %d) to %d failed\n",
-                static_cast<int>(block.size()),
-                target);
-        MPI_Abort(MPI_COMM_WORLD, send_errorcode);
-    }
-
-    if (MPI_Send(ids.data(),
-                 static_cast<int>(ids.size()),
-                 MPI_INT,
-                 target,
-                 tag,
-                 MPI_COMM_WORLD) != MPI_SUCCESS) {
-        fprintf(stderr,
-                "Sending block rows identifier %d to %d to rank %d failed\n",
-                first,
-                last,
-                target);
-        MPI_Abort(MPI_COMM_WORLD, send_errorcode);
-    }
-}
-
 static std::tuple<std::string, int, int, CommunicationTag>
 mpi_worker()
 {
@@ -387,9 +370,9 @@ struct Access
      * vle::value::Value pointer by browsing the experimental condition of the
      * \e vpz arguement.
      */
-    vle::value::Value* value(VpzPtr vpz) const
+    vle::value::Value* value(vle::vpz::Vpz& vpz) const
     {
-        auto& cnd = vpz->project().experiment().conditions().get(condition);
+        auto& cnd = vpz.project().experiment().conditions().get(condition);
         auto& elem = cnd.valueOfPort(port);
 
         if (params.empty())
@@ -772,6 +755,371 @@ operator<<(std::ostream& os, const std::unique_ptr<vle::value::Matrix>& value)
     return os;
 }
 
+/**
+ * @e BinaryRecord appends the result of one simulation to a buffer using the
+ * binary result format read by the manager (see @c cvle_read_binary in
+ * vle/manager/details/cvle_specific.hpp). Integers are 32 bits unsigned and
+ * reals are IEEE 754 doubles, both in the native byte order.
+ *
+ * @code
+ * record  := magic size status id (message | views) padding
+ * magic   := 0x424c5643 ("CVLB")
+ * size    := size of the record in bytes (a multiple of 8)
+ * status  := 0 on success, 1 on failure
+ * id      := string, the `id_i_j' or the kept columns of the row
+ * message := string, the error message (on failure)
+ * views   := count view*
+ * view    := string columns rows string* padding double*
+ * string  := length char*
+ * @endcode
+ *
+ * The @e padding aligns the reals and the next record on 8 bytes: the
+ * values of a view are stored column by column and the first column is the
+ * time. Values that are not double, integer or boolean are stored as NaN.
+ */
+class BinaryRecord
+{
+    std::string& m_buffer;
+    std::string::size_type m_start;
+
+    void put(std::uint32_t value)
+    {
+        m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void put(const std::string& str)
+    {
+        put(static_cast<std::uint32_t>(str.size()));
+        m_buffer.append(str);
+    }
+
+    void pad()
+    {
+        m_buffer.append((8 - (m_buffer.size() - m_start) % 8) % 8, '\0');
+    }
+
+    static double to_double(const vle::value::Value* value)
+    {
+        if (value) {
+            switch (value->getType()) {
+            case vle::value::Value::DOUBLE:
+                return value->toDouble().value();
+            case vle::value::Value::INTEGER:
+                return value->toInteger().value();
+            case vle::value::Value::BOOLEAN:
+                return value->toBoolean().value() ? 1.0 : 0.0;
+            default:
+                break;
+            }
+        }
+
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    void finish()
+    {
+        pad();
+        auto size = static_cast<std::uint32_t>(m_buffer.size() - m_start);
+        std::memcpy(&m_buffer[m_start + sizeof(std::uint32_t)],
+                    &size,
+                    sizeof(size));
+    }
+
+public:
+    static const std::uint32_t magic = 0x424c5643;
+
+    BinaryRecord(std::string& buffer)
+      : m_buffer(buffer)
+      , m_start(buffer.size())
+    {}
+
+    void write_error(const std::string& id, const std::string& message)
+    {
+        put(magic);
+        put(0u);
+        put(1u);
+        put(id);
+        put(message);
+        finish();
+    }
+
+    void write(const std::string& id, const vle::value::Map& result)
+    {
+        std::uint32_t views = 0;
+        for (const auto& it : result)
+            if (it.second && it.second->isMatrix())
+                ++views;
+
+        put(magic);
+        put(0u);
+        put(0u);
+        put(id);
+        put(views);
+
+        for (const auto& it : result) {
+            if (not it.second || not it.second->isMatrix())
+                continue;
+
+            const auto& matrix = it.second->toMatrix();
+            auto columns = static_cast<std::uint32_t>(matrix.columns());
+            auto rows = static_cast<std::uint32_t>(
+              matrix.rows() > 0 ? matrix.rows() - 1 : 0);
+
+            put(it.first);
+            put(columns);
+            put(rows);
+
+            for (std::uint32_t c = 0; c != columns; ++c) {
+                const auto& name = matrix.get(c, 0);
+                put(name && name->isString() ? name->toString().value()
+                                             : std::string());
+            }
+
+            pad();
+
+            for (std::uint32_t c = 0; c != columns; ++c) {
+                for (std::uint32_t r = 1; r <= rows; ++r) {
+                    double value = to_double(matrix.get(c, r).get());
+                    m_buffer.append(reinterpret_cast<const char*>(&value),
+                                    sizeof(value));
+                }
+            }
+        }
+
+        finish();
+    }
+};
+
+#ifndef _WIN32
+/**
+ * @e Isolation runs the rows of a @e Worker into a child process forked
+ * from the worker process once the model is loaded. Rows are sent one by
+ * one through a socket. If the child process crashes or exceeds the
+ * timeout, the row fails and a new child process is forked, from the
+ * unchanged worker, for the next rows.
+ */
+class Isolation
+{
+public:
+    using Function =
+      std::function<void(const std::string&, int, std::string&)>;
+
+private:
+    Function m_function;
+    std::chrono::milliseconds m_timeout;
+    pid_t m_pid;
+    int m_fd;
+
+    static bool send_all(int fd, const void* buffer, std::size_t size)
+    {
+        const char* ptr = static_cast<const char*>(buffer);
+
+        while (size > 0) {
+            ssize_t ret = ::send(fd, ptr, size, MSG_NOSIGNAL);
+            if (ret < 0 and errno == EINTR)
+                continue;
+            if (ret <= 0)
+                return false;
+
+            ptr += ret;
+            size -= static_cast<std::size_t>(ret);
+        }
+
+        return true;
+    }
+
+    static bool recv_all(int fd, void* buffer, std::size_t size, int timeout)
+    {
+        char* ptr = static_cast<char*>(buffer);
+
+        while (size > 0) {
+            if (timeout >= 0) {
+                pollfd pfd{ fd, POLLIN, 0 };
+                int ret = ::poll(&pfd, 1, timeout);
+                if (ret < 0 and errno == EINTR)
+                    continue;
+                if (ret <= 0)
+                    return false;
+            }
+
+            ssize_t ret = ::recv(fd, ptr, size, 0);
+            if (ret < 0 and errno == EINTR)
+                continue;
+            if (ret <= 0)
+                return false;
+
+            ptr += ret;
+            size -= static_cast<std::size_t>(ret);
+        }
+
+        return true;
+    }
+
+    [[noreturn]] void child(int fd)
+    {
+        std::string row, output;
+        std::array<std::int32_t, 2> header;
+
+        try {
+            while (recv_all(fd, header.data(), sizeof(header), -1)) {
+                row.resize(static_cast<std::size_t>(header[1]));
+                if (not recv_all(fd, &row[0], row.size(), -1))
+                    break;
+
+                output.clear();
+                m_function(row, header[0], output);
+
+                auto size = static_cast<std::uint32_t>(output.size());
+                if (not send_all(fd, &size, sizeof(size)) or
+                    not send_all(fd, output.data(), output.size()))
+                    break;
+            }
+        } catch (const std::exception& e) {
+            fprintf(stderr, "worker process fails: %s\n", e.what());
+            fflush(stderr);
+            ::_exit(EXIT_FAILURE);
+        }
+
+        ::_exit(EXIT_SUCCESS);
+    }
+
+    void start()
+    {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds))
+            throw vle::utils::InternalError(
+              _("Fail to build the socket of the worker process: %s"),
+              strerror(errno));
+
+        fflush(nullptr);
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            ::close(fds[0]);
+            ::close(fds[1]);
+            throw vle::utils::InternalError(
+              _("Fail to fork the worker process: %s"), strerror(errno));
+        }
+
+        if (pid == 0) {
+            ::close(fds[0]);
+            child(fds[1]);
+        }
+
+        ::close(fds[1]);
+        m_pid = pid;
+        m_fd = fds[0];
+    }
+
+    /**
+     * Stop the child process and return the reason of its failure.
+     */
+    std::string stop(bool timeout)
+    {
+        std::string reason;
+
+        if (m_pid > 0) {
+            if (timeout)
+                ::kill(m_pid, SIGKILL);
+
+            int status = 0;
+            while (::waitpid(m_pid, &status, 0) < 0 and errno == EINTR)
+                ;
+
+            if (timeout)
+                reason = vle::utils::format(
+                  _("cvle worker error: simulation timeout (%ld ms)"),
+                  static_cast<long>(m_timeout.count()));
+            else if (WIFSIGNALED(status))
+                reason =
+                  vle::utils::format(_("cvle worker error: worker process "
+                                       "killed by signal %d"),
+                                     WTERMSIG(status));
+            else
+                reason =
+                  vle::utils::format(_("cvle worker error: worker process "
+                                       "exits with code %d"),
+                                     WEXITSTATUS(status));
+        }
+
+        if (m_fd >= 0)
+            ::close(m_fd);
+
+        m_pid = -1;
+        m_fd = -1;
+
+        return reason;
+    }
+
+public:
+    Isolation(Function function, std::chrono::milliseconds timeout)
+      : m_function(std::move(function))
+      , m_timeout(timeout)
+      , m_pid(-1)
+      , m_fd(-1)
+    {}
+
+    ~Isolation()
+    {
+        if (m_fd >= 0)
+            ::close(m_fd);
+
+        if (m_pid > 0)
+            while (::waitpid(m_pid, nullptr, 0) < 0 and errno == EINTR)
+                ;
+    }
+
+    Isolation(const Isolation&) = delete;
+    Isolation& operator=(const Isolation&) = delete;
+
+    /**
+     * Run the @e row into the child process and append its output to @e
+     * output.
+     *
+     * @return true on success, false if the child process fails. In this
+     * case, @e error is the reason of the failure.
+     */
+    bool run(const std::string& row,
+             int row_id,
+             std::string& output,
+             std::string& error)
+    {
+        if (m_pid < 0)
+            start();
+
+        std::array<std::int32_t, 2> header{
+            { row_id, static_cast<std::int32_t>(row.size()) }
+        };
+        int timeout = m_timeout.count() > 0
+                        ? static_cast<int>(m_timeout.count())
+                        : -1;
+        std::uint32_t size = 0;
+
+        if (not send_all(m_fd, header.data(), sizeof(header)) or
+            not send_all(m_fd, row.data(), row.size())) {
+            error = stop(false);
+            return false;
+        }
+
+        if (not recv_all(m_fd, &size, sizeof(size), timeout)) {
+            pollfd pfd{ m_fd, POLLIN, 0 };
+            bool expired = timeout >= 0 and ::poll(&pfd, 1, 0) == 0;
+            error = stop(expired);
+            return false;
+        }
+
+        std::string::size_type begin = output.size();
+        output.resize(begin + size);
+        if (not recv_all(m_fd, &output[begin], size, -1)) {
+            output.resize(begin);
+            error = stop(false);
+            return false;
+        }
+
+        return true;
+    }
+};
+#endif
+
 class Worker
 {
 private:
@@ -779,21 +1127,65 @@ private:
 
     vle::utils::ContextPtr m_context;
     std::chrono::milliseconds m_timeout;
-    std::unique_ptr<vle::manager::Simulation> m_simulator;
+    std::unique_ptr<vle::manager::Simulation> m_simulator; // spawn mode
+    std::unique_ptr<vle::manager::PreparedSimulation> m_prepared;
     VpzPtr m_vpz;
     std::unique_ptr<Columns> m_columns;             // used for simple values
     std::unique_ptr<ConditionsBackup> m_conditions; // used for complex values
+#ifndef _WIN32
+    std::unique_ptr<Isolation> m_isolation;
+#endif
+    std::ostringstream m_text;
     bool m_warnings;
     bool m_more_output_details;
+    bool m_binary_output;
 
-    void simulate(std::ostream& os, int row_id)
+    vle::vpz::Vpz& vpz()
     {
-        vle::manager::Error error;
+        return m_prepared ? m_prepared->vpz() : *m_vpz;
+    }
+
+    MapPtr simulate(int row_id, vle::manager::Error& error)
+    {
+        if (m_prepared) {
+            m_prepared->setInstance(row_id);
+            return m_prepared->run(&error);
+        }
 
         auto vpz = std::make_unique<vle::vpz::Vpz>(*m_vpz.get());
         vpz->project().setInstance(row_id);
 
-        auto result = m_simulator->run(std::move(vpz), &error);
+        return m_simulator->run(std::move(vpz), &error);
+    }
+
+    void simulate(std::string& buffer, const std::string& id, int row_id)
+    {
+        vle::manager::Error error;
+        auto result = simulate(row_id, error);
+        BinaryRecord record(buffer);
+
+        if (error.code) {
+            if (m_warnings)
+                fprintf(stderr,
+                        _("Simulation failed. %s [code: %d] in %s\n"),
+                        error.message.c_str(),
+                        error.code,
+                        id.c_str());
+
+            record.write_error(id, error.message);
+        } else if (result == nullptr) {
+            record.write_error(id,
+                               "cvle worker error: no result (try storage as"
+                               " output plugin)");
+        } else {
+            record.write(id, *result);
+        }
+    }
+
+    void simulate(std::ostream& os, int row_id)
+    {
+        vle::manager::Error error;
+        auto result = simulate(row_id, error);
 
         if (error.code) {
             if (m_warnings) {
@@ -833,38 +1225,160 @@ private:
         }
     }
 
+    /**
+     * Assign the values of the @e row to the conditions of the vpz.
+     *
+     * @return the identifier of the row: the kept columns or the @e id of
+     * the complex values.
+     */
+    std::string apply(const std::string& row, vle::vpz::Conditions& conds)
+    {
+        if (m_columns) { // use columns
+            std::vector<std::string> output;
+            boost::algorithm::split(
+              output, row, boost::algorithm::is_any_of(","));
+
+            for (std::size_t i = 0, e = output.size(); i != e; ++i) {
+                std::string current = cleanup_token(output[i]);
+                m_columns->update(i, current);
+            }
+
+            std::ostringstream id;
+            id << *m_columns;
+            return id.str();
+        }
+
+        // use vpz
+        vle::vpz::Vpz temp;
+        temp.parseMemory(row);
+        conds = temp.project().experiment().conditions();
+        m_conditions->modify(vpz(), conds);
+        return m_conditions->getId(conds);
+    }
+
+    void restore(const vle::vpz::Conditions& conds)
+    {
+        if (not m_columns)
+            m_conditions->restoreBackup(vpz(), conds);
+    }
+
+    /**
+     * Simulate the @e row and append its results to @e output.
+     */
+    void run_row(const std::string& row, int row_id, std::string& output)
+    {
+        vle::vpz::Conditions conds;
+        std::string id = apply(row, conds);
+
+        if (m_binary_output) {
+            simulate(output, id, row_id);
+        } else {
+            m_text.str(std::string());
+            m_text << id;
+            if (not m_columns)
+                m_text << '\n';
+
+            simulate(m_text, row_id);
+
+            if (not m_columns)
+                m_text << '\n';
+            output += m_text.str();
+        }
+
+        restore(conds);
+    }
+
+    /**
+     * Append the failure of the simulation of the @e row to @e output.
+     */
+    void fail_row(const std::string& row,
+                  const std::string& message,
+                  std::string& output)
+    {
+        vle::vpz::Conditions conds;
+        std::string id = apply(row, conds);
+        restore(conds);
+
+        if (m_warnings)
+            fprintf(stderr, _("%s in %s\n"), message.c_str(), id.c_str());
+
+        if (m_binary_output) {
+            BinaryRecord(output).write_error(id, message);
+        } else {
+            output += id;
+            if (not m_columns)
+                output += '\n';
+            if (not m_warnings) {
+                output += message;
+                output += '\n';
+            }
+            if (not m_columns)
+                output += '\n';
+        }
+    }
+
 public:
     Worker(std::chrono::milliseconds timeout,
            const std::string& vpz,
            bool withoutspawn,
+           bool withoutisolation,
            bool warnings,
-           bool more_output_details)
+           bool more_output_details,
+           bool binary_output)
       : m_context(vle::utils::make_context())
       , m_timeout(timeout)
       , m_simulator(nullptr)
       , m_warnings(warnings)
       , m_more_output_details(more_output_details)
+      , m_binary_output(binary_output)
     {
+        m_context->set_log_priority(3);
+
+        m_text.imbue(std::locale::classic());
+        m_text << std::setprecision(static_cast<int>(std::floor(
+                    std::numeric_limits<double>::digits * std::log10(2) + 2)))
+               << std::scientific;
+
         if (not withoutspawn) {
             m_simulator = std::make_unique<vle::manager::Simulation>(
               m_context,
               vle::manager::SIMULATION_NONE |
                 vle::manager::SIMULATION_SPAWN_PROCESS,
               m_timeout);
-        } else {
-            m_simulator = std::make_unique<vle::manager::Simulation>(
-              m_context,
-              vle::manager::SIMULATION_NONE,
-              m_timeout);
+            m_vpz = std::make_unique<vle::vpz::Vpz>(vpz);
+            return;
         }
-        m_context->set_log_priority(3);
-        m_vpz = std::make_unique<vle::vpz::Vpz>(vpz);
+
+        //
+        // The model is loaded once and the rows update the conditions of
+        // the prepared vpz in place. Simulations run into a child process
+        // restarted only if a simulation crashes.
+        //
+
+        m_prepared = std::make_unique<vle::manager::PreparedSimulation>(
+          m_context, std::make_unique<vle::vpz::Vpz>(vpz));
+
+        // The children of the isolation are forked after: they find the
+        // dynamics resolved. The errors are reported by the rows.
+        vle::manager::Error error;
+        m_prepared->prepare(&error);
+
+#ifndef _WIN32
+        if (not withoutisolation)
+            m_isolation = std::make_unique<Isolation>(
+              [this](const std::string& row, int row_id, std::string& out) {
+                  run_row(row, row_id, out);
+              },
+              m_timeout);
+#else
+        (void)withoutisolation;
+#endif
     }
 
     void init(const std::string& header)
     {
         if (header == "_cvle_complex_values") {
-            m_conditions = std::make_unique<ConditionsBackup>(*m_vpz);
+            m_conditions = std::make_unique<ConditionsBackup>(vpz());
         } else {
             namespace ba = boost::algorithm;
 
@@ -878,7 +1392,7 @@ public:
                 if (access.is_undefined_string()) {
                     m_columns->add(access.condition);
                 } else {
-                    m_columns->add(access.value(m_vpz));
+                    m_columns->add(access.value(vpz()));
                 }
             }
         }
@@ -888,46 +1402,31 @@ public:
     {
         fprintf(stdout, "worker run row %d to %d\n", first, last);
 
-        std::ostringstream result;
-        std::vector<std::string> output;
+        std::string result;
         std::string::size_type begin = 0u;
         std::string::size_type end;
-        result.imbue(std::locale::classic());
-        result << std::setprecision(static_cast<int>(std::floor(
-                    std::numeric_limits<double>::digits * std::log10(2) + 2)))
-               << std::scientific;
 
         for (begin = 0, end = block.find('\n'); begin < block.size();
              begin = end + 1, end = block.find('\n', end + 1)) {
-            std::string buffer(block, begin, end - begin);
-            if (m_columns) { // use columns
-                boost::algorithm::split(
-                  output, buffer, boost::algorithm::is_any_of(","));
-
-                for (std::size_t i = 0, e = output.size(); i != e; ++i) {
-                    std::string current = cleanup_token(output[i]);
-                    m_columns->update(i, current);
-                }
+            std::string row(block, begin, end - begin);
+
+#ifndef _WIN32
+            if (m_isolation) {
+                std::string error;
+                if (not m_isolation->run(row, first, result, error))
+                    fail_row(row, error, result);
 
-                result << *m_columns;
-                simulate(result, first++);
-            } else { // use vpz
-                vle::vpz::Vpz temp;
-                temp.parseMemory(buffer);
-                vle::vpz::Conditions conds =
-                  temp.project().experiment().conditions();
-                std::vector<std::string> condNames = conds.conditionnames();
-                m_conditions->modify(*m_vpz, conds);
-                result << m_conditions->getId(conds) << "\n";
-                simulate(result, first++);
-                m_conditions->restoreBackup(*m_vpz, conds);
-                result << '\n';
+                ++first;
+                continue;
             }
+#endif
+
+            run_row(row, first++, result);
         }
 
         fprintf(stdout, "worker finishes at %d (%d)\n", first, last);
 
-        return result.str();
+        return result;
     }
 };
 
@@ -959,19 +1458,70 @@ class Root
     int m_last_id;
     int m_blocksize;
 
+    // The output stream is written by a dedicated thread: the master
+    // continues to dispatch blocks while results are written.
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::string> m_queue;
+    bool m_closed;
+
+    void writer_loop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        for (;;) {
+            m_cv.wait(lock, [this] { return m_closed or not m_queue.empty(); });
+
+            if (m_queue.empty())
+                break;
+
+            std::string block = std::move(m_queue.front());
+            m_queue.pop_front();
+
+            lock.unlock();
+            m_os->write(block.data(),
+                        static_cast<std::streamsize>(block.size()));
+            lock.lock();
+        }
+
+        m_os->flush();
+    }
+
 public:
-    Root(const std::string& input, const std::string& output, int blocksize)
+    Root(const std::string& input,
+         const std::string& output,
+         int blocksize,
+         bool binary_output)
       : m_is(&std::cin, no_deleter<std::istream>())
       , m_os(&std::cout, no_deleter<std::ostream>())
       , m_first_id(0)
       , m_last_id(0)
       , m_blocksize(blocksize)
+      , m_closed(false)
     {
         if (!input.empty())
             m_is = open<std::ifstream>(input);
 
-        if (!output.empty())
-            m_os = open<std::ofstream>(output);
+        if (!output.empty()) {
+            auto ofs = std::make_shared<std::ofstream>(
+              output.c_str(),
+              binary_output ? std::ios::out | std::ios::binary
+                            : std::ios::out);
+
+            if (!ofs->is_open())
+                throw vle::utils::FileError(_("Fail to open file %s"),
+                                            output.c_str());
+
+            m_os = ofs;
+        }
+
+        m_writer = std::thread(&Root::writer_loop, this);
+    }
+
+    ~Root()
+    {
+        close();
     }
 
     bool header(std::string& header)
@@ -980,6 +1530,16 @@ public:
         return m_is.get()->good();
     }
 
+    void blocksize(int blocksize)
+    {
+        m_blocksize = std::max(1, blocksize);
+    }
+
+    int blocksize() const
+    {
+        return m_blocksize;
+    }
+
     bool read(std::string& block, int& first, int& last)
     {
         m_first_id = m_last_id;
@@ -1011,71 +1571,302 @@ public:
         return true;
     }
 
-    void write(const std::string& block)
+    void write(std::string block)
     {
-        (*m_os.get()) << block;
-        m_os->flush();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.emplace_back(std::move(block));
+        }
+        m_cv.notify_one();
+    }
+
+    /**
+     * Wait until all the blocks are written.
+     */
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_cv.notify_one();
+
+        if (m_writer.joinable())
+            m_writer.join();
+    }
+};
+
+/**
+ * @e Dispatcher keeps the blocks sent to a worker and not yet computed. MPI
+ * guarantees that the messages between two ranks are not overtaking, so
+ * results are received in the same order as the blocks are sent.
+ */
+class Dispatcher
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    struct Block
+    {
+        std::string buffer;
+        std::array<int, 2> ids;
+        std::array<MPI_Request, 2> requests;
+        clock::time_point sent;
+    };
+
+private:
+    std::vector<std::deque<std::unique_ptr<Block>>> m_inflight;
+    std::vector<clock::time_point> m_last_done;
+    std::vector<std::unique_ptr<Block>> m_sending;
+    double m_rows_per_second;
+    std::size_t m_size;
+
+public:
+    Dispatcher(int world_size)
+      : m_inflight(world_size)
+      , m_last_done(world_size)
+      , m_rows_per_second(0.0)
+      , m_size(0)
+    {}
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    std::size_t size(int rank) const
+    {
+        return m_inflight[rank].size();
+    }
+
+    /**
+     * Send the block with non blocking messages. The buffers are kept
+     * until the end of the communication (see @c test).
+     */
+    void send(int rank, std::string block, int first, int last)
+    {
+        auto b = std::make_unique<Block>();
+        b->buffer = std::move(block);
+        b->ids = { { first, last } };
+        b->sent = clock::now();
+
+        if (MPI_Isend(b->buffer.data(),
+                      static_cast<int>(b->buffer.size()),
+                      MPI_CHAR,
+                      rank,
+                      worker_block_todo_tag,
+                      MPI_COMM_WORLD,
+                      &b->requests[0]) != MPI_SUCCESS or
+            MPI_Isend(b->ids.data(),
+                      static_cast<int>(b->ids.size()),
+                      MPI_INT,
+                      rank,
+                      worker_block_todo_tag,
+                      MPI_COMM_WORLD,
+                      &b->requests[1]) != MPI_SUCCESS) {
+            fprintf(stderr,
+                    "Sending block rows identifier %d to %d to rank %d "
+                    "failed\n",
+                    first,
+                    last,
+                    rank);
+            MPI_Abort(MPI_COMM_WORLD, send_errorcode);
+        }
+
+        if (m_inflight[rank].empty())
+            m_last_done[rank] = b->sent;
+
+        m_inflight[rank].emplace_back(std::move(b));
+        ++m_size;
+    }
+
+    /**
+     * The result of the oldest block sent to @e rank is received: update
+     * the throughput estimation with the duration of the computation of
+     * this block by the worker.
+     */
+    void done(int rank)
+    {
+        assert(not m_inflight[rank].empty());
+
+        auto now = clock::now();
+        auto b = std::move(m_inflight[rank].front());
+        m_inflight[rank].pop_front();
+        --m_size;
+
+        auto start = std::max(b->sent, m_last_done[rank]);
+        m_last_done[rank] = now;
+
+        double duration = std::chrono::duration<double>(now - start).count();
+        int rows = b->ids[1] - b->ids[0];
+        if (duration > 0.0 and rows > 0) {
+            double rate = rows / duration;
+            m_rows_per_second = m_rows_per_second == 0.0
+                                  ? rate
+                                  : 0.5 * (m_rows_per_second + rate);
+        }
+
+        m_sending.emplace_back(std::move(b));
+        test();
+    }
+
+    /**
+     * Release the buffers of the finished communications.
+     */
+    void test()
+    {
+        auto it = std::remove_if(
+          m_sending.begin(), m_sending.end(), [](std::unique_ptr<Block>& b) {
+              int flag = 0;
+              MPI_Testall(2, b->requests.data(), &flag, MPI_STATUSES_IGNORE);
+              return flag != 0;
+          });
+
+        m_sending.erase(it, m_sending.end());
+    }
+
+    void wait()
+    {
+        for (auto& b : m_sending)
+            MPI_Waitall(2, b->requests.data(), MPI_STATUSES_IGNORE);
+
+        m_sending.clear();
+    }
+
+    /**
+     * @return the number of rows a worker computes in @e duration according
+     * to the measured throughput or @e 0 if no measure is available.
+     */
+    int rows(std::chrono::milliseconds duration) const
+    {
+        double rows = m_rows_per_second * duration.count() / 1000.0;
+
+        return rows >= std::numeric_limits<int>::max()
+                 ? std::numeric_limits<int>::max()
+                 : static_cast<int>(rows);
     }
 };
 
 int
 run_as_master(const std::string& inputfile,
               const std::string& outputfile,
-              int blocksize)
+              int blocksize,
+              int inflight,
+              std::chrono::milliseconds blockduration,
+              bool binary_output)
 {
     int ret = EXIT_SUCCESS;
     int blockid = 0;
-    int first, last;
 
     try {
         int world_size;
         MPI_Comm_size(MPI_COMM_WORLD, &world_size);
 
-        Root r(inputfile, outputfile, blocksize);
-        std::vector<bool> workers(world_size, false);
-        std::string block, header;
+        Root r(inputfile, outputfile, blocksize, binary_output);
+        Dispatcher dispatcher(world_size);
+        std::string header;
         r.header(header);
 
         for (int rank = 1; rank != world_size; ++rank)
             mpi_send_string(rank, worker_block_header_tag, header);
 
-        for (int rank = 1; rank < world_size; ++rank) {
-            if (r.read(block, first, last)) {
-                mpi_send_block(
-                  rank, worker_block_todo_tag, block, first, last);
-                workers[rank] = true;
-            } else
-                break;
-        }
+        //
+        // The next block is read while the workers simulate. With a block
+        // duration, the size of the block follows the throughput of the
+        // workers.
+        //
 
-        bool end = false; // Stop when all buffer are sent.
-        int from;
-        CommunicationTag tag;
-        while (end == false) {
-            std::tie(block, from, tag) = mpi_recv_string();
+        std::string next;
+        int first = 0, last = 0;
+        bool has_next = false;
+        bool end = false;
 
-            assert(tag == worker_block_end_tag);
+        auto read_next = [&]() {
+            if (not has_next and not end) {
+                if (blockduration.count() > 0) {
+                    int rows = dispatcher.rows(blockduration);
+                    if (rows > 0)
+                        r.blocksize(rows);
+                }
+
+                has_next = r.read(next, first, last) and not next.empty();
+                end = not has_next;
+            }
 
-            workers[from] = false;
-            r.write(block);
-            end = !r.read(block, first, last);
+            return has_next;
+        };
+
+        auto send_next = [&](int rank) {
+            if (not read_next())
+                return false;
+
+            printf(_("master sends block %d (%d rows) to %d\n"),
+                   blockid++,
+                   last - first,
+                   rank);
+            dispatcher.send(rank, std::move(next), first, last);
+            next.clear();
+            has_next = false;
+            return true;
+        };
 
-            if (not block.empty()) {
-                printf(_("master sends block %d to %d\n"), blockid++, from);
-                mpi_send_block(
-                  from, worker_block_todo_tag, block, first, last);
-                workers[from] = true;
+        for (int i = 0; i < inflight; ++i)
+            for (int rank = 1; rank < world_size; ++rank)
+                send_next(rank);
+
+        while (dispatcher.size() > 0) {
+            int flag = 0;
+            MPI_Status status;
+            MPI_Iprobe(MPI_ANY_SOURCE,
+                       worker_block_end_tag,
+                       MPI_COMM_WORLD,
+                       &flag,
+                       &status);
+
+            if (not flag) {
+                if (not has_next and not end) {
+                    read_next();
+                    continue;
+                }
+
+                dispatcher.test();
+                MPI_Probe(MPI_ANY_SOURCE,
+                          worker_block_end_tag,
+                          MPI_COMM_WORLD,
+                          &status);
             }
-        }
 
-        while (std::find(workers.begin(), workers.end(), true) !=
-               workers.end()) {
-            std::tie(block, from, tag) = mpi_recv_string();
-            assert(tag == worker_block_end_tag);
-            workers[from] = false;
-            r.write(block);
+            int size;
+            MPI_Get_count(&status, MPI_CHAR, &size);
+            std::string block(static_cast<std::string::size_type>(size),
+                              ' ');
+
+            if (MPI_Recv(&block[0],
+                         size,
+                         MPI_CHAR,
+                         status.MPI_SOURCE,
+                         worker_block_end_tag,
+                         MPI_COMM_WORLD,
+                         MPI_STATUS_IGNORE) != MPI_SUCCESS) {
+                fprintf(stderr,
+                        "Receiving block buffer (size: %d) from %d failed\n",
+                        size,
+                        status.MPI_SOURCE);
+                MPI_Abort(MPI_COMM_WORLD, recv_errorcode);
+            }
+
+            dispatcher.done(status.MPI_SOURCE);
+            r.write(std::move(block));
+
+            while (dispatcher.size(status.MPI_SOURCE) <
+                     static_cast<std::size_t>(inflight) and
+                   send_next(status.MPI_SOURCE))
+                ;
         }
 
+        dispatcher.wait();
+        r.close();
+
         for (int rank = 1; rank < world_size; ++rank)
             mpi_send_string(rank, worker_end_tag, "ok");
     } catch (const std::exception& e) {
@@ -1090,11 +1881,19 @@ int
 run_as_worker(const std::string& vpz,
               std::chrono::milliseconds timeout,
               bool withoutspawn,
+              bool withoutisolation,
               bool warnings,
-              bool more_output_details)
+              bool more_output_details,
+              bool binary_output)
 {
     try {
-        Worker w(timeout, vpz, withoutspawn, warnings, more_output_details);
+        Worker w(timeout,
+                 vpz,
+                 withoutspawn,
+                 withoutisolation,
+                 warnings,
+                 more_output_details,
+                 binary_output);
         std::string block;
         int from;
         int first, last;
@@ -1160,11 +1959,22 @@ show_help()
              "  output-file,o file              csv output file\n"
              "  withoutspawn                    Perform simulation into "
              "the worker process\n"
+             "  withoutisolation                With withoutspawn, do not "
+             "restart the simulations of a worker after a crash (not with "
+             "timeout)\n"
              "  warnings                        Show warnings in output\n"
              "  template,t file                 Generate a template csv input "
              "file\n"
              "  block-size,b size               Set number of lines to be sent"
-             " [default 5000]\n"));
+             " [default 5000]\n"
+             "  in-flight size                  Set number of blocks sent to "
+             "a worker in advance [default 2]\n"
+             "  block-duration [int]            Adapt the number of lines to "
+             "be sent to simulate a block in this duration (miliseconds)\n"
+             "  more-output-details             Write the id and all the "
+             "views of each simulation\n"
+             "  binary-output                   Write the results with the "
+             "binary format read by the manager\n"));
 }
 
 int
@@ -1174,9 +1984,15 @@ main(int argc, char* argv[])
     std::string input_file, output_file, template_file;
     std::chrono::milliseconds timeout{ std::chrono::milliseconds::zero() };
     int withoutspawn = 0;
+    int withoutisolation = 0;
     int warnings = 0;
     int more_output_details = 0;
+    int binary_output = 0;
     int block_size = 5000;
+    int in_flight = 2;
+    std::chrono::milliseconds block_duration{
+        std::chrono::milliseconds::zero()
+    };
     int ret = EXIT_SUCCESS;
 
     const char* const short_opts = "hP:i:o:t:b:";
@@ -1188,9 +2004,13 @@ main(int argc, char* argv[])
         { "output-file", 1, nullptr, 'o' },
         { "template", 1, nullptr, 't' },
         { "withoutspawn", 0, &withoutspawn, 1 },
+        { "withoutisolation", 0, &withoutisolation, 1 },
         { "warnings", 0, &warnings, 1 },
         { "block-size", 1, nullptr, 'b' },
         { "more-output-details", 0, &more_output_details, 1 },
+        { "binary-output", 0, &binary_output, 1 },
+        { "in-flight", 1, nullptr, 0 },
+        { "block-duration", 1, nullptr, 0 },
         { nullptr, 0, nullptr, 0 }
     };
     int opt_index;
@@ -1214,6 +2034,28 @@ main(int argc, char* argv[])
                             _("Bad timeout: %s Assume no timeout\n"),
                             ::optarg);
                 }
+            } else if (not strcmp(long_opts[opt_index].name, "in-flight")) {
+                try {
+                    in_flight = std::max(1, std::stoi(::optarg));
+                } catch (const std::exception& /*e*/) {
+                    fprintf(stderr,
+                            _("Bad in-flight: %s. Assume in-flight=%d\n"),
+                            ::optarg,
+                            in_flight);
+                }
+            } else if (not strcmp(long_opts[opt_index].name,
+                                  "block-duration")) {
+                try {
+                    long int t = std::stol(::optarg);
+                    if (t <= 0)
+                        throw std::exception();
+                    block_duration = std::chrono::milliseconds(t);
+                } catch (const std::exception& /*e*/) {
+                    fprintf(stderr,
+                            _("Bad block duration: %s. Assume fixed block "
+                              "size\n"),
+                            ::optarg);
+                }
             }
             break;
         case 'h':
@@ -1250,6 +2092,19 @@ main(int argc, char* argv[])
         };
     }
 
+#ifndef _WIN32
+    const bool isolated = not withoutisolation;
+#else
+    const bool isolated = false;
+#endif
+    if (timeout != std::chrono::milliseconds::zero() and withoutspawn and
+        not isolated) {
+        fprintf(stderr,
+                _("The timeout needs a child process: it cannot be used "
+                  "with both withoutspawn and withoutisolation\n"));
+        return EXIT_FAILURE;
+    }
+
     std::vector<std::string> vpz(argv + ::optind, argv + argc);
     if (vpz.size() > 1) {
         fprintf( stderr,
@@ -1284,25 +2139,34 @@ main(int argc, char* argv[])
     int status;
     if (rank == 0) {
         printf(_("block size: %d\n"
+                 "in-flight : %d\n"
                  "package   : %s\n"
                  "timeout   : %ld\n"
                  "input csv : %s\n"
                  "output csv: %s\n"
                  "vpz       : %s\n"),
                block_size,
+               in_flight,
                package_name.c_str(),
                timeout.count(),
                (input_file.empty()) ? "stdin" : input_file.c_str(),
                (output_file.empty()) ? "stdout" : output_file.c_str(),
                vpz.front().c_str());
 
-        status = run_as_master(input_file, output_file, block_size);
+        status = run_as_master(input_file,
+                               output_file,
+                               block_size,
+                               in_flight,
+                               block_duration,
+                               binary_output);
     } else {
         status = run_as_worker(vpz_abs,
                                timeout,
                                withoutspawn,
+                               withoutisolation,
                                warnings,
-                               more_output_details);
+                               more_output_details,
+                               binary_output);
     }
 
     MPI_Finalize();
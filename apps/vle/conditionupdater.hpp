@@ -32,12 +32,15 @@
 #include <vle/value/Boolean.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
+#include <vle/value/Map.hpp>
 #include <vle/value/Set.hpp>
 #include <vle/value/String.hpp>
 #include <vle/value/Value.hpp>
 #include <vle/vpz/Vpz.hpp>
 
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #ifdef VLE_HAVE_NLS
@@ -76,6 +79,8 @@ private:
 
     vle::value::Value* get(vle::vpz::Vpz& file, const accessor& access) const;
 
+    void assign(vle::value::Value* value, const accessor& access) const;
+
 public:
     /**
      * @brief Add a condition change if @c cnd parameter is valid.
@@ -118,6 +123,32 @@ public:
      */
     void update(vle::vpz::Vpz& file) const;
 
+    /**
+     * @brief Build the inputs of an experiment plan for the @c
+     * vle::manager::Manager.
+     *
+     * @details Each condition port changed several times (or at least once
+     * if @c all is true) without map or set accessor becomes an entry of
+     * the @c plan: the key is @c prefix followed by @c condition.port and
+     * the value is a @c vle::value::Set of the values converted to the
+     * type of the port value in @c file. Other changes are applied to @c
+     * file like @c update.
+     *
+     * @code
+     * ConditionUpdater cond;
+     * cond.emplace("condition.port=1");
+     * cond.emplace("condition.port=2");
+     *
+     * vle::value::Map plan;
+     * cond.update(file, plan, "input_", false);
+     * // plan: { "input_condition.port": (1, 2) }
+     * @endcode
+     */
+    void update(vle::vpz::Vpz& file,
+                vle::value::Map& plan,
+                const std::string& prefix,
+                bool all) const;
+
     /**
      * @brief Return true condition change is empty, false is at least one
      * @change is available.
@@ -237,38 +268,95 @@ ConditionUpdater::update(vle::vpz::Vpz& file) const
         if (value == nullptr)
             continue;
 
-        // If @c str is empty, user want to use the default @c
-        // vle::value::Value from the origin VPZ file. Otherwise, we
-        // convert the value from the string.
+        assign(value, elem);
+    }
+}
+
+inline void
+ConditionUpdater::update(vle::vpz::Vpz& file,
+                         vle::value::Map& plan,
+                         const std::string& prefix,
+                         bool all) const
+{
+    std::map<std::pair<std::string, std::string>, std::vector<std::size_t>>
+      ports;
+
+    for (std::size_t i = 0, e = m_access.size(); i != e; ++i)
+        if (m_access[i].value_stack.empty())
+            ports[std::make_pair(m_access[i].condition, m_access[i].port)]
+              .emplace_back(i);
+
+    std::vector<bool> in_plan(m_access.size(), false);
 
-        if (elem.value.empty())
+    for (const auto& elem : ports) {
+        if (elem.second.size() < 2 and not all)
             continue;
 
-        switch (value->getType()) {
-        case vle::value::Value::BOOLEAN:
-            value->toBoolean().value() = vle::utils::to<bool>(elem.value);
-            break;
+        auto& cnd = file.project().experiment().conditions().get(
+          elem.first.first);
+        const auto& origin = cnd.valueOfPort(elem.first.second);
+
+        if (not origin)
+            throw vle::utils::ArgError(_("Fails to convert `%s.%s': no value"),
+                                       elem.first.first.c_str(),
+                                       elem.first.second.c_str());
+
+        auto values = std::make_unique<vle::value::Set>();
+        for (auto i : elem.second) {
+            auto value = origin->clone();
+            assign(value.get(), m_access[i]);
+            values->add(std::move(value));
+            in_plan[i] = true;
+        }
 
-        case vle::value::Value::INTEGER:
-            value->toInteger().value() =
-              vle::utils::to<std::int32_t>(elem.value);
-            break;
+        plan.add(prefix + elem.first.first + '.' + elem.first.second,
+                 std::move(values));
+    }
 
-        case vle::value::Value::DOUBLE:
-            value->toDouble().value() = vle::utils::to<double>(elem.value);
-            break;
+    for (std::size_t i = 0, e = m_access.size(); i != e; ++i) {
+        if (in_plan[i])
+            continue;
 
-        case vle::value::Value::STRING:
-            value->toString().value() = elem.value;
-            break;
+        auto* value = get(file, m_access[i]);
+        if (value)
+            assign(value, m_access[i]);
+    }
+}
 
-        default:
-            throw vle::utils::ArgError(
-              _("Fails to convert `%s.%s' to complex type"),
-              elem.condition.c_str(),
-              elem.port.c_str());
-            break;
-        }
+inline void
+ConditionUpdater::assign(vle::value::Value* value,
+                         const ConditionUpdater::accessor& elem) const
+{
+    // If @c str is empty, user want to use the default @c
+    // vle::value::Value from the origin VPZ file. Otherwise, we
+    // convert the value from the string.
+
+    if (elem.value.empty())
+        return;
+
+    switch (value->getType()) {
+    case vle::value::Value::BOOLEAN:
+        value->toBoolean().value() = vle::utils::to<bool>(elem.value);
+        break;
+
+    case vle::value::Value::INTEGER:
+        value->toInteger().value() = vle::utils::to<std::int32_t>(elem.value);
+        break;
+
+    case vle::value::Value::DOUBLE:
+        value->toDouble().value() = vle::utils::to<double>(elem.value);
+        break;
+
+    case vle::value::Value::STRING:
+        value->toString().value() = elem.value;
+        break;
+
+    default:
+        throw vle::utils::ArgError(
+          _("Fails to convert `%s.%s' to complex type"),
+          elem.condition.c_str(),
+          elem.port.c_str());
+        break;
     }
 }
 
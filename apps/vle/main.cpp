@@ -45,6 +45,8 @@
 #include <vle/utils/Package.hpp>
 #include <vle/utils/RemoteManager.hpp>
 #include <vle/utils/Tools.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Map.hpp>
 #include <vle/value/Matrix.hpp>
 #include <vle/vle.hpp>
 
@@ -240,8 +242,15 @@ show_help() noexcept
         "standard error output\n"
         "write-output  output simulation results into XML output file. "
         "Need a file name parameter.\n"
+        "              In manager mode, one file by simulation named\n"
+        "              file-input-replicate.ext\n"
+        "binary-output write-output uses the binary encoding of the values "
+        "instead of XML\n"
         "timeout       limit the simulation duration with a timeout in "
         "miliseconds.\n"
+        "simulation-server  run the simulation server of the spawn mode on "
+        "the file\n"
+        "              descriptor parameter (see vle.command.vle.server)\n"
         "name          change the identifier of the experiment. To use in\n"
         "                combination with the condition parameter to\n"
         "                generate simulation's output into different file\n"
@@ -250,8 +259,13 @@ show_help() noexcept
         "                map is the key of a map\n"
         "                integer is the vector index of a set\n"
         "                value can be boolean, integer, real or string\n"
+        "replicate     in manager mode, add a replicate value with:\n"
+        "              --replicate condition.port=1234\n"
         "processor,j Select number of processor in manager mode [>= 1]\n"
-        "manager,m  Use the manager mode to run experimental frames\n"
+        "manager,m  Use the manager mode to run experimental frames:\n"
+        "                each condition port changed several times with\n"
+        "                the condition parameter is an input of the\n"
+        "                experiment plan, simulations run in parallel\n"
         "verbose,V   Verbose mode 0 - 7. [default 3]\n"
         "                0 system is unusable\n"
         "                1 action must be taken immediately\n"
@@ -376,58 +390,146 @@ search_vpz(const std::string& param, std::shared_ptr<vle::utils::Package> pkg)
     return std::string();
 }
 
+/**
+ * Build the file name of the results of the simulation @c input, @c
+ * replicate of the experiment plan: the indices are inserted before the
+ * extension of @c output_file (@c out.xml gives @c out-0-1.xml).
+ */
+static std::string
+manager_output_file(const std::string& output_file,
+                    unsigned int input,
+                    unsigned int replicate)
+{
+    vle::utils::Path p(output_file);
+    auto extension = p.extension();
+    auto filename = output_file.substr(0, output_file.size() -
+                                            extension.size());
+
+    return vle::utils::format(
+      "%s-%u-%u%s", filename.c_str(), input, replicate, extension.c_str());
+}
+
+/**
+ * Write the results of a simulation into the file @c filename as XML or
+ * with the binary encoding of @c vle::value::writeBinary.
+ *
+ * @return false if the file can not be opened.
+ */
+static bool
+write_output(const std::string& filename,
+             const vle::value::Map& res,
+             bool binary_output)
+{
+    if (binary_output) {
+        std::ofstream ofs(filename, std::ios::out | std::ios::binary);
+        if (not ofs)
+            return false;
+
+        std::string buffer;
+        vle::value::writeBinary(res, buffer);
+        ofs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    } else {
+        std::ofstream ofs(filename);
+        if (not ofs)
+            return false;
+
+        ofs << std::showpoint << std::fixed
+            << std::setprecision(std::numeric_limits<double>::digits10);
+        res.writeXml(ofs);
+    }
+
+    return true;
+}
+
 static int
-run_manager(vle::utils::ContextPtr /*ctx*/,
-            std::chrono::milliseconds /*timeout*/,
-            const std::string& /*name*/,
-            const vle::ConditionUpdater& /*conds*/,
-            CmdArgs::const_iterator /*it*/,
-            CmdArgs::const_iterator /*end*/,
-            int /*processor*/,
-            std::shared_ptr<vle::utils::Package> /*pkg*/)
+run_manager(vle::utils::ContextPtr ctx,
+            std::chrono::milliseconds timeout,
+            const std::string& name,
+            const std::string& output_file,
+            bool binary_output,
+            const vle::ConditionUpdater& conds,
+            const vle::ConditionUpdater& replicates,
+            CmdArgs::const_iterator it,
+            CmdArgs::const_iterator end,
+            int processor,
+            std::shared_ptr<vle::utils::Package> pkg)
 {
-//    vle::manager::Manager man(ctx,
-//                              convert_log_mode(ctx),
-//                              vle::manager::SIMULATION_NONE |
-//                                vle::manager::SIMULATION_NO_RETURN,
-//                              timeout,
-//                              &std::cout);
-//    int success = EXIT_SUCCESS;
-//
-//    for (; (it != end) and (success == EXIT_SUCCESS); ++it) {
-//        std::string vpzAbsolutePath = search_vpz(*it, pkg);
-//        if (vpzAbsolutePath.empty()) {
-//            success = EXIT_FAILURE;
-//        } else {
-//            vle::manager::Error error;
-//
-//            auto file = std::make_unique<vle::vpz::Vpz>(vpzAbsolutePath);
-//            if (file and not conds.empty())
-//                conds.update(*file);
-//
-//            if (not name.empty())
-//                file->project().experiment().setName(name);
-//
-//            std::unique_ptr<vle::value::Matrix> res =
-//              man.run(std::move(file),
-//                      static_cast<std::uint32_t>(processor),
-//                      0,
-//                      1,
-//                      &error);
-//
-//            if (error.code) {
-//                fprintf(stderr,
-//                        _("Experimental frames `%s' throws error %s"),
-//                        it->c_str(),
-//                        error.message.c_str());
-//                success = EXIT_FAILURE;
-//            }
-//        }
-//    }
-//
-//    return success;
-    //TODO a réecrire avec un fichier en entrée ? Ou a laisser tomber ?
-    return EXIT_FAILURE;
+    vle::manager::Manager man(ctx,
+                              processor > 1 ? vle::manager::PARALLEL_THREADS
+                                            : vle::manager::PARALLEL_MONO,
+                              static_cast<unsigned int>(processor),
+                              vle::manager::SIMULATION_NONE,
+                              timeout,
+                              true,
+                              false,
+                              vle::utils::Path::temp_directory_path().string(),
+                              12365);
+    int success = EXIT_SUCCESS;
+
+    for (; (it != end) and (success == EXIT_SUCCESS); ++it) {
+        std::string vpzAbsolutePath = search_vpz(*it, pkg);
+        if (vpzAbsolutePath.empty()) {
+            success = EXIT_FAILURE;
+            continue;
+        }
+
+        vle::manager::Error error;
+        vle::value::Map plan;
+        std::unique_ptr<vle::vpz::Vpz> vpz;
+
+        try {
+            vpz = std::make_unique<vle::vpz::Vpz>(vpzAbsolutePath);
+            conds.update(*vpz, plan, "input_", false);
+            replicates.update(*vpz, plan, "replicate_", true);
+        } catch (const std::exception& e) {
+            fprintf(stderr,
+                    _("Experimental frames `%s' throws error %s\n"),
+                    it->c_str(),
+                    e.what());
+            success = EXIT_FAILURE;
+            continue;
+        }
+
+        if (not name.empty())
+            vpz->project().experiment().setName(name);
+
+        //
+        // Results are written as soon as each simulation finishes, the
+        // manager does not keep them in memory.
+        //
+
+        man.runPlan(
+          std::move(vpz),
+          plan,
+          [&output_file, binary_output, &it](
+            unsigned int input,
+            unsigned int replicate,
+            std::unique_ptr<vle::value::Map> res) {
+              if (not res or output_file.empty())
+                  return;
+
+              auto filename =
+                manager_output_file(output_file, input, replicate);
+
+              if (not write_output(filename, *res, binary_output))
+                  fprintf(stderr,
+                          _("Simulation`%s' file to write output"
+                            " file %s\n"),
+                          it->c_str(),
+                          filename.c_str());
+          },
+          error);
+
+        if (error.code) {
+            fprintf(stderr,
+                    _("Experimental frames `%s' throws error %s\n"),
+                    it->c_str(),
+                    error.message.c_str());
+            success = EXIT_FAILURE;
+        }
+    }
+
+    return success;
 }
 
 static int
@@ -435,6 +537,7 @@ run_simulation(vle::utils::ContextPtr ctx,
                std::chrono::milliseconds timeout,
                const std::string& name,
                const std::string& output_file,
+               bool binary_output,
                const vle::ConditionUpdater& conds,
                CmdArgs::const_iterator it,
                CmdArgs::const_iterator end,
@@ -468,22 +571,13 @@ run_simulation(vle::utils::ContextPtr ctx,
                         error.message.c_str());
                 success = EXIT_FAILURE;
             } else {
-                if (res and not output_file.empty()) {
-                    std::ofstream ofs(output_file);
-
-                    if (not ofs) {
-                        fprintf(stderr,
-                                _("Simulation`%s' file to write output"
-                                  " file %s\n"),
-                                it->c_str(),
-                                output_file.c_str());
-                    } else {
-                        ofs << std::showpoint << std::fixed
-                            << std::setprecision(
-                                 std::numeric_limits<double>::digits10);
-                        res->writeXml(ofs);
-                    }
-                }
+                if (res and not output_file.empty() and
+                    not write_output(output_file, *res, binary_output))
+                    fprintf(stderr,
+                            _("Simulation`%s' file to write output"
+                              " file %s\n"),
+                            it->c_str(),
+                            output_file.c_str());
             }
         }
     }
@@ -512,7 +606,9 @@ init_package(vle::utils::Package& pkg, const CmdArgs& args)
 static int
 manage_package_mode(vle::utils::ContextPtr ctx,
                     const std::string& output_file,
+                    bool binary_output,
                     const vle::ConditionUpdater& conds,
+                    const vle::ConditionUpdater& replicates,
                     std::chrono::milliseconds timeout,
                     const std::string& name,
                     bool manager_mode,
@@ -591,11 +687,27 @@ manage_package_mode(vle::utils::ContextPtr ctx,
         ret = EXIT_FAILURE;
     else if (it != end) {
         if (manager_mode)
-            ret =
-              run_manager(ctx, timeout, name, conds, it, end, processor, pkg);
+            ret = run_manager(ctx,
+                              timeout,
+                              name,
+                              output_file,
+                              binary_output,
+                              conds,
+                              replicates,
+                              it,
+                              end,
+                              processor,
+                              pkg);
         else
-            ret = run_simulation(
-              ctx, timeout, name, output_file, conds, it, end, pkg);
+            ret = run_simulation(ctx,
+                                 timeout,
+                                 name,
+                                 output_file,
+                                 binary_output,
+                                 conds,
+                                 it,
+                                 end,
+                                 pkg);
     }
 
     return ret;
@@ -762,7 +874,9 @@ manage_remote_mode(vle::utils::ContextPtr ctx, CmdArgs args)
 static int
 manage_nothing_mode(vle::utils::ContextPtr ctx,
                     const std::string& output_file,
+                    bool binary_output,
                     const vle::ConditionUpdater& conds,
+                    const vle::ConditionUpdater& replicates,
                     std::chrono::milliseconds timeout,
                     const std::string& name,
                     bool manager_mode,
@@ -781,10 +895,27 @@ manage_nothing_mode(vle::utils::ContextPtr ctx,
     int ret = EXIT_SUCCESS;
 
     if (manager_mode)
-        ret = run_manager(ctx, timeout, name, conds, it, end, processor, pkg);
+        ret = run_manager(ctx,
+                          timeout,
+                          name,
+                          output_file,
+                          binary_output,
+                          conds,
+                          replicates,
+                          it,
+                          end,
+                          processor,
+                          pkg);
     else
-        ret =
-          run_simulation(ctx, timeout, name, output_file, conds, it, end, pkg);
+        ret = run_simulation(ctx,
+                             timeout,
+                             name,
+                             output_file,
+                             binary_output,
+                             conds,
+                             it,
+                             end,
+                             pkg);
 
     return ret;
 }
@@ -864,6 +995,7 @@ int
 main(int argc, char** argv)
 {
     vle::ConditionUpdater conds;
+    vle::ConditionUpdater replicates;
     std::string output_file;
     std::string name;
     std::chrono::milliseconds timeout{ std::chrono::milliseconds::zero() };
@@ -873,6 +1005,8 @@ main(int argc, char** argv)
     int log_dest = 1;
     int restart_conf = 0;
     int manager = 0;
+    int binary_output = 0;
+    int server_fd = -1;
     int opt_index;
     int ret = EXIT_SUCCESS;
 
@@ -881,13 +1015,22 @@ main(int argc, char** argv)
                                         { "version", 0, nullptr, 'v' },
                                         { "infos", 0, nullptr, 'i' },
                                         { "name", 1, nullptr, 0 },
-                                        { "condition", 0, nullptr, 'c' },
+                                        { "condition", 1, nullptr, 'c' },
+                                        { "replicate", 1, nullptr, 0 },
                                         { "restart", 0, &restart_conf, 1 },
                                         { "log-file", 0, &log_dest, 0 },
                                         { "log-stdout", 0, &log_dest, 1 },
                                         { "log-stderr", 0, &log_dest, 2 },
                                         { "write-output", 1, nullptr, 0 },
+                                        { "binary-output",
+                                          0,
+                                          &binary_output,
+                                          1 },
                                         { "timeout", 1, nullptr, 0 },
+                                        { "simulation-server",
+                                          1,
+                                          nullptr,
+                                          0 },
                                         { "verbose", 1, nullptr, 'V' },
                                         { "processor", 1, nullptr, 'j' },
                                         { "manager", 0, nullptr, 'm' },
@@ -917,8 +1060,26 @@ main(int argc, char** argv)
                             _("Bad timeout: %s. Assume no timeout\n"),
                             ::optarg);
                 }
-            } else if (not strcmp(long_opts[opt_index].name, "name"))
+            } else if (not strcmp(long_opts[opt_index].name,
+                                  "simulation-server")) {
+                try {
+                    server_fd = std::stoi(::optarg);
+                } catch (const std::exception& /* e */) {
+                    fprintf(stderr,
+                            _("Bad simulation server descriptor: %s\n"),
+                            ::optarg);
+                    mode |= CLI_MODE_END;
+                    ret = EXIT_FAILURE;
+                }
+            } else if (not strcmp(long_opts[opt_index].name, "name")) {
                 name = ::optarg;
+            } else if (not strcmp(long_opts[opt_index].name, "replicate")) {
+                if (not replicates.emplace(::optarg))
+                    fprintf(stderr,
+                            _("Bad replicate format: cond.port=value with"
+                              " value a single type (bool, real, integer or"
+                              " string).\n"));
+            }
             break;
         case 'h':
             mode |= CLI_MODE_END;
@@ -1019,13 +1180,24 @@ main(int argc, char** argv)
     else
         ctx->set_log_function(std::make_unique<vle_log_standard>());
 
+    //
+    // Started by a vle::manager::Simulation with the
+    // vle.command.vle.server setting.
+    //
+    if (server_fd >= 0)
+        return vle::manager::Simulation::serve(ctx, server_fd)
+                 ? EXIT_SUCCESS
+                 : EXIT_FAILURE;
+
     CmdArgs commands(argv + ::optind, argv + argc);
 
     switch (mode) {
     case CLI_MODE_PACKAGE:
         ret = manage_package_mode(ctx,
                                   output_file,
+                                  binary_output,
                                   conds,
+                                  replicates,
                                   timeout,
                                   name,
                                   manager,
@@ -1041,7 +1213,9 @@ main(int argc, char** argv)
     case CLI_MODE_NOTHING:
         ret = manage_nothing_mode(ctx,
                                   output_file,
+                                  binary_output,
                                   conds,
+                                  replicates,
                                   timeout,
                                   name,
                                   manager,
@@ -262,6 +262,30 @@ public:
         return {};
     }
 
+    /**
+     * @brief Process an observation event of a real or an integer without
+     * allocation of \e value::Value. The kernel calls this function before
+     * the \e observation function, which is not called if \e value is
+     * assigned. The default implementation assigns nothing.
+     *
+     * @code
+     * void scalarObservation(const vle::devs::ObservationEvent& event,
+     *                        vle::devs::ScalarObservation& value) const
+     * {
+     *     if (event.onPort("x"))
+     *         value.setReal(m_x);
+     *     else if (event.onPort("n"))
+     *         value.setInteger(m_n);
+     * }
+     * @endcode
+     *
+     * @param event the state event with of the port.
+     * @param[out] value the observed real or integer.
+     */
+    virtual void scalarObservation(const ObservationEvent& /* event */,
+                                   ScalarObservation& /* value */) const
+    {}
+
     /**
      * @brief When the simulation of the atomic model is finished, the
      * finish method is invoked.
@@ -27,6 +27,7 @@
 #ifndef VLE_DEVS_EXTERNALEVENT_HPP
 #define VLE_DEVS_EXTERNALEVENT_HPP
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -43,6 +44,15 @@ namespace devs {
  * object is use into the \e vle::devs::Dynamics::externalTransition()
  * function.
  *
+ * Boolean, integer and real values can be stored into the event without
+ * allocation with the \e setBoolean, \e setInteger and \e setDouble
+ * functions and read with the \e getBooleanValue, \e getIntegerValue and
+ * \e getDoubleValue functions. The \e value::Value accessors (\e
+ * attributes(), \e getDouble() etc.) remain available: they convert the
+ * inline value into a \e value::Value at the first call.
+ *
+ * Events received by a model refer to the input port name interned by the
+ * simulation kernel instead of a copy.
  */
 class VLE_API ExternalEvent
 {
@@ -63,18 +73,92 @@ public:
       , m_port(std::move(port))
     {}
 
+    /**
+     * Build a copy of the event \e event received on the input port \e
+     * port. The \e port string must outlive the event: it is the input
+     * port name interned by the simulation kernel.
+     */
+    ExternalEvent(const ExternalEvent& event, const std::string& port)
+      : m_attributes(event.m_attributes)
+      , m_port_name(&port)
+      , m_scalar(event.m_scalar)
+      , m_type(event.m_type)
+    {}
+
     const std::string& getPortName() const
     {
-        return m_port;
+        return m_port_name ? *m_port_name : m_port;
     }
 
     bool onPort(const std::string& port) const
     {
-        return m_port == port;
+        return getPortName() == port;
     }
 
     /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+    /**
+     * Assign a boolean to the event without allocation.
+     *
+     * \param value the value.
+     */
+    void setBoolean(bool value) noexcept
+    {
+        m_attributes.reset();
+        m_scalar.boolean = value;
+        m_type = scalar_type::boolean;
+    }
+
+    /**
+     * Assign an integer to the event without allocation.
+     *
+     * \param value the value.
+     */
+    void setInteger(std::int32_t value) noexcept
+    {
+        m_attributes.reset();
+        m_scalar.integer = value;
+        m_type = scalar_type::integer;
+    }
+
+    /**
+     * Assign a real to the event without allocation.
+     *
+     * \param value the value.
+     */
+    void setDouble(double value) noexcept
+    {
+        m_attributes.reset();
+        m_scalar.real = value;
+        m_type = scalar_type::real;
+    }
+
+    /**
+     * Get the boolean assigned with \e setBoolean or \e addBoolean.
+     *
+     * \exception can throw \e utils::ArgError if the event does not
+     * store a boolean.
+     */
+    bool getBooleanValue() const;
+
+    /**
+     * Get the integer assigned with \e setInteger or \e addInteger.
+     *
+     * \exception can throw \e utils::ArgError if the event does not
+     * store an integer.
+     */
+    std::int32_t getIntegerValue() const;
+
+    /**
+     * Get the real assigned with \e setDouble or \e addDouble.
+     *
+     * \exception can throw \e utils::ArgError if the event does not
+     * store a real.
+     */
+    double getDoubleValue() const;
+
+    /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
     /**
      * Initialize the \e attributes with a Boolean.
      *
@@ -378,7 +462,7 @@ public:
      */
     bool haveAttributes() const
     {
-        return m_attributes.get() != nullptr;
+        return m_type != scalar_type::none or m_attributes.get() != nullptr;
     }
 
     /**
@@ -388,6 +472,9 @@ public:
      */
     std::shared_ptr<value::Value>& attributes()
     {
+        if (m_type != scalar_type::none)
+            box();
+
         return m_attributes;
     }
 
@@ -398,12 +485,43 @@ public:
      */
     const std::shared_ptr<value::Value>& attributes() const
     {
+        if (m_type != scalar_type::none)
+            box();
+
         return m_attributes;
     }
 
 private:
-    std::shared_ptr<value::Value> m_attributes;
+    enum class scalar_type : std::uint8_t
+    {
+        none, // The value, if any, is stored into m_attributes.
+        boolean,
+        integer,
+        real
+    };
+
+    union scalar
+    {
+        bool boolean;
+        std::int32_t integer;
+        double real;
+    };
+
+    //
+    // The inline value is converted into m_attributes by the value::Value
+    // accessors, even the const ones, hence the mutable.
+    //
+
+    mutable std::shared_ptr<value::Value> m_attributes;
     std::string m_port;
+    const std::string* m_port_name = nullptr;
+    mutable scalar m_scalar = { false };
+    mutable scalar_type m_type = scalar_type::none;
+
+    /**
+     * Move the inline value into a newly allocated \e m_attributes.
+     */
+    void box() const;
 
     template<typename T, typename... Args>
     T& pp_add(Args&&... args)
@@ -411,6 +529,7 @@ private:
         auto value = std::make_shared<T>(std::forward<Args>(args)...);
         auto ret = value.get();
         m_attributes = value;
+        m_type = scalar_type::none;
         return *ret;
     }
 };
@@ -27,11 +27,14 @@
 #ifndef VLE_DEVS_OBSERVATION_EVENT_HPP
 #define VLE_DEVS_OBSERVATION_EVENT_HPP 1
 
+#include <cstdint>
+#include <memory>
 #include <utility>
 #include <vector>
 #include <vle/DllDefines.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/utils/Exception.hpp>
+#include <vle/value/Value.hpp>
 
 namespace vle {
 namespace devs {
@@ -88,6 +91,78 @@ private:
     std::string m_viewName;
     std::string m_portName;
 };
+
+/**
+ * @brief A real or an integer observation filled by the \e
+ * Dynamics::scalarObservation function. The value is stored inline and
+ * sent to the output plug-ins without allocation of \e value::Value.
+ */
+class VLE_API ScalarObservation
+{
+public:
+    enum class Type : std::uint8_t
+    {
+        NONE,
+        REAL,
+        INTEGER
+    };
+
+    ScalarObservation() = default;
+
+    void setReal(double value) noexcept
+    {
+        m_type = Type::REAL;
+        m_real = value;
+    }
+
+    void setInteger(std::int32_t value) noexcept
+    {
+        m_type = Type::INTEGER;
+        m_integer = value;
+    }
+
+    void reset() noexcept
+    {
+        m_type = Type::NONE;
+    }
+
+    Type type() const noexcept
+    {
+        return m_type;
+    }
+
+    /**
+     * @return true if a real or an integer is assigned.
+     */
+    explicit operator bool() const noexcept
+    {
+        return m_type != Type::NONE;
+    }
+
+    double real() const noexcept
+    {
+        return m_real;
+    }
+
+    std::int32_t integer() const noexcept
+    {
+        return m_integer;
+    }
+
+    /**
+     * @return the observation as a \e value::Double or a \e
+     * value::Integer, or \e nullptr if nothing is assigned.
+     */
+    std::unique_ptr<value::Value> toValue() const;
+
+private:
+    Type m_type = Type::NONE;
+    union
+    {
+        double m_real = 0.0;
+        std::int32_t m_integer;
+    };
+};
 }
 } // namespace vle devs
 
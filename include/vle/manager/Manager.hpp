@@ -28,6 +28,7 @@
 #define VLE_MANAGER_MANAGER_HPP
 
 #include <chrono>
+#include <functional>
 #include <vle/DllDefines.hpp>
 #include <vle/manager/Types.hpp>
 #include <vle/utils/Context.hpp>
@@ -52,6 +53,16 @@ class VLE_API Manager
 public:
     using result_type = std::unique_ptr<value::Matrix>;
 
+    /**
+     * @brief Function called by the streaming @e runPlan for each finished
+     * simulation with the input index, the replicate index and the
+     * results of the simulation (the @c value::Map of the views).
+     */
+    using result_function =
+      std::function<void(unsigned int input_index,
+                         unsigned int replicate_index,
+                         std::unique_ptr<value::Map> result)>;
+
     //complete constructor
     Manager(utils::ContextPtr context,
                 ParallelOptions paralleloption,      // type of parallelisation
@@ -124,6 +135,17 @@ public:
      *                  either an init event list or a value Map
      * @param[out] err, an error structure
      *
+     * Simulations are distributed dynamically to the threads: each thread
+     * takes the next simulation as soon as it finishes the previous one.
+     * The optional 'expected_duration' entry of @e init (a Set or a Tuple
+     * with one value per input) runs the longest expected simulations
+     * first. The utilization of each thread is logged at the end. Each
+     * thread aggregates the outputs of its simulations on its own, the
+     * aggregations are merged when all simulations are finished. Without
+     * SIMULATION_SPAWN_PROCESS, the outputs of a view with only 'last',
+     * 'max', 'sum' or 'mse' integrations are integrated during the
+     * simulations instead of storing all the observed values.
+     *
      * @return the simulated values
      */
     std::unique_ptr<value::Map> runPlan(
@@ -140,6 +162,27 @@ public:
             std::unique_ptr<vpz::Vpz> exp,
             const devs::InitEventList& init,
             Error& err);
+
+    /**
+     * @brief Simulates the experiment plan without aggregation: the
+     * results of each simulation are given to @e output as soon as the
+     * simulation finishes and are not kept by the manager.
+     *
+     * The outputs of the plan are ignored and all the views of the model
+     * are kept. The instance of the project is set to the index of the
+     * simulation (input_index * M + replicate_index) to build distinct
+     * file names for file based output plug-ins. Calls to @e output are
+     * serialized. Only mono and threads parallel options are available.
+     *
+     * @param[in] exp, the model to simulate
+     * @param[in] init, structure for the configuration of simulations
+     * @param[in] output, the function called for each simulation
+     * @param[out] err, an error structure
+     */
+    void runPlan(std::unique_ptr<vpz::Vpz> exp,
+                 const vle::value::Map& init,
+                 const result_function& output,
+                 Error& err);
     /**
      * @brief Get the embedded model configured for specific input and
      * replicate values
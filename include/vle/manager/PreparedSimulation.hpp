@@ -0,0 +1,127 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MANAGER_PREPAREDSIMULATION_HPP
+#define VLE_MANAGER_PREPAREDSIMULATION_HPP
+
+#include <memory>
+#include <string>
+#include <vle/DllDefines.hpp>
+#include <vle/manager/Types.hpp>
+#include <vle/utils/Context.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+namespace vle {
+namespace manager {
+
+/**
+ * @c manager::PreparedSimulation runs several simulations of the same
+ * model.
+ *
+ * The @c vpz::Vpz is kept by the @c manager::PreparedSimulation and the
+ * dynamics are resolved only once, by @e prepare or at the first
+ * simulation. For each run, only
+ * the graph of models is copied and the condition ports changed with @e
+ * setConditionPort are re-applied. Simulations run in the current thread
+ * without timeout.
+ *
+ * @code
+ * vle::manager::PreparedSimulation sim(ctx, std::move(vpz));
+ * vle::manager::Error error;
+ *
+ * for (int i = 0; i != 100; ++i) {
+ *     sim.setConditionPort("cond", "seed", vle::value::Integer::create(i));
+ *     auto result = sim.run(&error);
+ * }
+ * @endcode
+ *
+ * @attention A @c manager::PreparedSimulation must be used by only one
+ * thread at a time.
+ */
+class VLE_API PreparedSimulation
+{
+public:
+    PreparedSimulation(utils::ContextPtr context,
+                       std::unique_ptr<vpz::Vpz> vpz);
+
+    PreparedSimulation(const PreparedSimulation& other) = delete;
+    PreparedSimulation& operator=(const PreparedSimulation& other) = delete;
+
+    ~PreparedSimulation();
+
+    /**
+     * @brief Assign the @e value to the @e port of the @e condition for
+     * the next simulations. The port is added if it does not exist.
+     *
+     * @throw utils::ArgError if the condition does not exist.
+     */
+    void setConditionPort(const std::string& condition,
+                          const std::string& port,
+                          std::shared_ptr<value::Value> value);
+
+    /**
+     * @brief Assign the instance of the project for the next simulations
+     * (see @c vpz::Project::setInstance).
+     */
+    void setInstance(int instance);
+
+    /**
+     * @brief Get the prepared @c vpz::Vpz.
+     */
+    const vpz::Vpz& vpz() const;
+
+    /**
+     * @brief Get the prepared @c vpz::Vpz to update its conditions in
+     * place: the next simulations use the values of the conditions at the
+     * time of @e run.
+     */
+    vpz::Vpz& vpz();
+
+    /**
+     * @brief Resolve the dynamics and load the output plug-ins of the
+     * model without running a simulation. A process forked after @e
+     * prepare runs its simulations without loading them again.
+     *
+     * @param error filled like @e run if a dynamics or a plug-in can not
+     * be loaded.
+     */
+    void prepare(Error* error);
+
+    /**
+     * @brief Run a simulation with the current values of the conditions.
+     *
+     * @return The results of the views like @c manager::Simulation::run.
+     */
+    std::unique_ptr<value::Map> run(Error* error);
+
+private:
+    class Pimpl;
+    std::unique_ptr<Pimpl> mPimpl;
+};
+}
+}
+
+#endif
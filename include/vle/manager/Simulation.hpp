@@ -63,6 +63,18 @@ public:
     std::unique_ptr<value::Map> run(std::unique_ptr<vpz::Vpz> vpz,
                                     Error* error);
 
+    /**
+     * Run the simulation server of the @c SIMULATION_SPAWN_PROCESS mode:
+     * read the simulations to run on the file descriptor @e fd until the
+     * connection is closed. Each simulation runs in a child process forked
+     * from the server, the shared libraries stay loaded between two
+     * simulations (see the @e vle.command.vle.server setting).
+     *
+     * @return true if the connection is closed normally, false on error or
+     * if the server is not available on this system.
+     */
+    static bool serve(utils::ContextPtr context, int fd);
+
 private:
     class Pimpl;
     std::unique_ptr<Pimpl> mPimpl;
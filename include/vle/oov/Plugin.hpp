@@ -27,6 +27,7 @@
 #ifndef VLE_OOV_PLUGIN_HPP
 #define VLE_OOV_PLUGIN_HPP
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <utility>
@@ -165,6 +166,29 @@ public:
                                  const std::string& view,
                                  const double& time) = 0;
 
+    /**
+     * Call when a new observable (the devs::Simulator and port name) is
+     * attached to a view. A plug-in which identifies its observables by an
+     * index (a column for instance) returns it as handle: the values of the
+     * observable are then sent with the \c onHandleValue function without
+     * the names of the simulator, parent and port.
+     *
+     * The default implementation calls \c onNewObservable and returns -1:
+     * the values are sent with the names to \c onValue.
+     *
+     * @return A handle greater or equal to 0 or -1.
+     */
+    virtual std::int32_t onNewObservableHandle(const std::string& simulator,
+                                               const std::string& parent,
+                                               const std::string& port,
+                                               const std::string& view,
+                                               const double& time)
+    {
+        onNewObservable(simulator, parent, port, view, time);
+
+        return -1;
+    }
+
     /**
      * Call whe a observable (the devs::Simulator and port name) is
      * deleted from a view.
@@ -185,6 +209,36 @@ public:
                          const double& time,
                          std::unique_ptr<value::Value> value) = 0;
 
+    /**
+     * Call when an external event is send to the view for the observable
+     * identified by the \c handle returned by \c onNewObservableHandle.
+     * Only called for handle greater or equal to 0.
+     */
+    virtual void onHandleValue(std::int32_t /*handle*/,
+                               const double& /*time*/,
+                               std::unique_ptr<value::Value> /*value*/)
+    {}
+
+    /**
+     * Call when a real is observed with the \c
+     * devs::Dynamics::scalarObservation function for the observable
+     * identified by the \c handle. The default implementation sends a \c
+     * value::Double to \c onHandleValue.
+     */
+    virtual void onHandleReal(std::int32_t handle,
+                              const double& time,
+                              double value);
+
+    /**
+     * Call when an integer is observed with the \c
+     * devs::Dynamics::scalarObservation function for the observable
+     * identified by the \c handle. The default implementation sends a \c
+     * value::Integer to \c onHandleValue.
+     */
+    virtual void onHandleInteger(std::int32_t handle,
+                                 const double& time,
+                                 std::int32_t value);
+
     /**
      * Call when the simulation is finished.
      * Return a pointer to the Matrix built during simulation, or NULL.
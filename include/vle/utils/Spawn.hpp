@@ -28,6 +28,7 @@
 #define VLE_UTILS_DETAILS_SPAWN_HPP
 
 #include <chrono>
+#include <functional>
 #include <string>
 #include <vector>
 #include <vle/DllDefines.hpp>
@@ -125,6 +126,41 @@ public:
      */
     bool wait();
 
+    /**
+     * Wait the end of the process and read its standard and error outputs.
+     * The calling thread sleeps until the process writes on its outputs or
+     * ends, no polling loop is required.
+     *
+     * @param output A string to append the standard output or nullptr.
+     * @param error A string to append the error output or nullptr.
+     * @param timeout If greater than zero, the process is killed when it
+     * does not end before the @e timeout.
+     *
+     * @return false if the process is killed or if an error occurred, true
+     * otherwise. Use the \c status() function to get the statutes of the
+     * sub-process.
+     */
+    bool wait(std::string* output,
+              std::string* error,
+              std::chrono::milliseconds timeout);
+
+    /**
+     * Receives the data read on the standard and error outputs of the
+     * sub-process since its previous call.
+     */
+    using OutputReader =
+      std::function<void(const std::string& output, const std::string& error)>;
+
+    /**
+     * Wait the end of the process like \c wait(output, error, timeout) but
+     * give the outputs to the @e reader as soon as they are read, the
+     * outputs are not kept in memory.
+     *
+     * @return false if the process is killed or if an error occurred, true
+     * otherwise.
+     */
+    bool wait(const OutputReader& reader, std::chrono::milliseconds timeout);
+
     /**
      * Try to kill the sub-process. If the process is not running, do
      * nothing. Do not forget to use the \c wait() function to get the
@@ -0,0 +1,76 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_VALUE_BINARY_HPP
+#define VLE_VALUE_BINARY_HPP 1
+
+#include <memory>
+#include <string>
+#include <vle/DllDefines.hpp>
+#include <vle/value/Value.hpp>
+
+namespace vle {
+namespace value {
+
+/**
+ * @brief Append the binary encoding of a value to a buffer.
+ *
+ * The encoding starts with a header (the 4 characters "VLEB" and a version
+ * number) followed by the value. Each value is a type tag followed by its
+ * payload: strings and containers are prefixed by their length, the reals
+ * of a Tuple or a Table and the trailing reals of the columns of a Matrix
+ * are stored as contiguous arrays. Integers and reals use the native byte
+ * order: the encoding is made to exchange values between processes of the
+ * same host (sub-process simulations, cvle), not to store them.
+ *
+ * @param value The value to encode.
+ * @param out The buffer where the encoding is appended.
+ * @throw utils::ArgError if the value contains a User value.
+ */
+VLE_API void
+writeBinary(const Value& value, std::string& out);
+
+/**
+ * @brief Check if a buffer starts with the header of the binary encoding.
+ */
+VLE_API bool
+isBinary(const char* buffer, std::size_t size);
+
+/**
+ * @brief Build a value from its binary encoding (see @c writeBinary). The
+ * arrays of reals are copied in one operation into the Tuple and Table
+ * without parsing.
+ *
+ * @param buffer The start of the encoding.
+ * @param size The size of the buffer.
+ * @throw utils::ArgError if the buffer is not a valid encoding.
+ */
+VLE_API std::unique_ptr<Value>
+readBinary(const char* buffer, std::size_t size);
+}
+} // namespace vle value
+
+#endif
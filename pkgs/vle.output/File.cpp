@@ -36,8 +36,10 @@
 #include <vle/value/String.hpp>
 
 #include <algorithm>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 
 namespace vle {
 namespace oov {
@@ -46,15 +48,29 @@ namespace plugin {
 File::File(const std::string& location)
   : Plugin(location)
   , m_time(-1.0)
+  , m_stream(nullptr)
+  , m_headcolumns(0)
+  , m_havehead(false)
   , m_isstart(false)
   , m_havefirstevent(false)
   , m_julian(false)
   , m_type(File::FILE)
   , m_flushbybag(false)
+  , m_asynchronous(true)
+  , m_head(0)
+  , m_tail(0)
+  , m_sleeping(false)
+  , m_waiting(false)
+  , m_failed(false)
 {}
 
 File::~File()
 {
+    if (m_writer.joinable()) {
+        push({ Record::STOP, 0, 0.0, 0.0, nullptr });
+        m_writer.join();
+    }
+
     m_file.close();
     m_buffer.clear();
 }
@@ -76,14 +92,14 @@ File::onParameter(const std::string& plugin,
         try {
             if (locale == "user") {
                 std::locale selected("");
-                m_file.imbue(selected);
+                m_stream.imbue(selected);
             } else {
                 std::locale selected(locale.c_str());
-                m_file.imbue(selected);
+                m_stream.imbue(selected);
             }
         } catch (...) {
             std::locale selected("C");
-            m_file.imbue(selected);
+            m_stream.imbue(selected);
         }
 
         if (map.exist("type")) {
@@ -123,6 +139,10 @@ File::onParameter(const std::string& plugin,
         if (map.exist("flush-by-bag")) {
             m_flushbybag = map.getBoolean("flush-by-bag");
         }
+
+        if (map.exist("asynchronous")) {
+            m_asynchronous = map.getBoolean("asynchronous");
+        }
     }
 
     if (!m_filetype)
@@ -141,37 +161,53 @@ File::onParameter(const std::string& plugin,
     m_filename = m_filenametmp;
     m_filename += m_filetype->extension();
 
-    m_file.open(m_filenametmp.c_str());
+    if (m_type == File::FILE) {
+        m_filebuffer.resize(buffer_size);
+        m_file.rdbuf()->pubsetbuf(m_filebuffer.data(), m_filebuffer.size());
+        m_file.open(m_filename.c_str());
+
+        if (not m_file.is_open()) {
+            throw utils::ArgError(
+              "Output plug-in '%s': cannot open file '%s'\n",
+              plugin.c_str(),
+              m_filename.c_str());
+        }
 
-    if (not m_file.is_open()) {
-        throw utils::ArgError("Output plug-in '%s': cannot open file '%s'\n",
-                              plugin.c_str(),
-                              m_filename.c_str());
+        m_stream.rdbuf(m_file.rdbuf());
+    } else if (m_type == File::STANDARD_OUT) {
+        m_stream.rdbuf(std::cout.rdbuf());
+    } else {
+        m_stream.rdbuf(std::cerr.rdbuf());
     }
 
-    m_file << std::setprecision(std::numeric_limits<double>::digits10);
+    m_stream << std::setprecision(std::numeric_limits<double>::digits10);
     parameters.reset();
+
+    // The standard and error outputs stay synchronous to keep the order
+    // with the other messages of the simulation.
+    if (m_type == File::FILE and m_asynchronous) {
+        m_queue.resize(queue_size);
+        m_writer = std::thread(&File::write, this);
+    }
 }
 
 void
 File::onNewObservable(const std::string& simulator,
                       const std::string& parent,
                       const std::string& portname,
-                      const std::string& /* view */,
+                      const std::string& view,
                       const double& time)
 {
-    if (m_isstart) {
-        flush();
-    } else {
-        if (not m_havefirstevent) {
-            m_time = time;
-            m_havefirstevent = true;
-        } else {
-            flush();
-            m_isstart = true;
-        }
-    }
+    onNewObservableHandle(simulator, parent, portname, view, time);
+}
 
+std::int32_t
+File::onNewObservableHandle(const std::string& simulator,
+                            const std::string& parent,
+                            const std::string& portname,
+                            const std::string& /* view */,
+                            const double& time)
+{
     std::string name(buildname(parent, simulator, portname));
 
     if (m_columns.find(name) != m_columns.end()) {
@@ -179,10 +215,16 @@ File::onNewObservable(const std::string& simulator,
           "Output plug-in: observable '%s' already exist", name.c_str());
     }
 
-    m_newbagwatcher[name] = -1.0;
-    m_columns[name] = m_buffer.size();
-    m_buffer.add(std::unique_ptr<value::Value>());
-    m_valid.push_back(false);
+    auto column = m_columns.size();
+    m_columns[name] = column;
+
+    post({ Record::NEW_COLUMN,
+           column,
+           time,
+           0.0,
+           value::String::create(name).release() });
+
+    return static_cast<std::int32_t>(column);
 }
 
 void
@@ -201,96 +243,301 @@ File::onValue(const std::string& simulator,
               const double& time,
               std::unique_ptr<value::Value> value)
 {
-    std::string name(buildname(parent, simulator, port));
-    Columns::iterator it;
-
     if (not simulator.empty()) {
-        name = buildname(parent, simulator, port);
-        it = m_columns.find(name);
+        std::string name(buildname(parent, simulator, port));
+        auto it = m_columns.find(name);
 
         if (it == m_columns.end())
             throw utils::InternalError(
               "Output plugin: columns '%s' does not exist. No observable ?",
               name.c_str());
 
-        if (m_isstart) {
-            if (time != m_time ||
-                (m_flushbybag && m_newbagwatcher[name] == time)) {
-                flush();
+        post({ Record::VALUE, it->second, time, 0.0, value.release() });
+    } else {
+        post({ Record::TIME, 0, time, 0.0, nullptr });
+    }
+}
+
+void
+File::onHandleValue(std::int32_t handle,
+                    const double& time,
+                    std::unique_ptr<value::Value> value)
+{
+    post({ Record::VALUE,
+           static_cast<std::size_t>(handle),
+           time,
+           0.0,
+           value.release() });
+}
+
+void
+File::onHandleReal(std::int32_t handle, const double& time, double value)
+{
+    post(
+      { Record::REAL, static_cast<std::size_t>(handle), time, value, nullptr });
+}
+
+void
+File::post(const Record& record)
+{
+    if (not m_writer.joinable()) {
+        apply(record);
+        return;
+    }
+
+    if (m_failed.load(std::memory_order_acquire)) {
+        delete record.value;
+        std::rethrow_exception(m_error);
+    }
+
+    push(record);
+}
+
+void
+File::push(const Record& record)
+{
+    const auto tail = m_tail.load(std::memory_order_relaxed);
+
+    for (int idle = 0;
+         tail - m_head.load(std::memory_order_acquire) == queue_size;) {
+        if (++idle < 64) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // The writer notifies under the lock once it sees m_waiting after
+        // its m_head store, so the wait cannot miss a free slot.
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_waiting.store(true);
+        while (tail - m_head.load() == queue_size)
+            m_space.wait(lock);
+        m_waiting.store(false);
+    }
+
+    m_queue[tail & (queue_size - 1)] = record;
+
+    // The sequential consistency of the m_tail store and the m_sleeping
+    // load ensures the writer sees the record or is woken up.
+    m_tail.store(tail + 1);
+    if (m_sleeping.load()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakeup.notify_one();
+    }
+}
+
+void
+File::write()
+{
+    auto head = m_head.load(std::memory_order_relaxed);
+    int idle = 0;
+
+    for (;;) {
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            if (++idle < 64) {
+                std::this_thread::yield();
+                continue;
             }
+
+            // The producer notifies under the lock once it sees m_sleeping
+            // after its m_tail store, so the wait cannot miss a record.
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_sleeping.store(true);
+            while (head == m_tail.load())
+                m_wakeup.wait(lock);
+            m_sleeping.store(false);
+            continue;
+        }
+
+        idle = 0;
+        const Record& record = m_queue[head & (queue_size - 1)];
+        const bool running = record.type < Record::FINISH;
+
+        // After an error, the records are only released until the end to
+        // never block the simulation.
+        if (m_failed.load(std::memory_order_relaxed)) {
+            delete record.value;
         } else {
-            if (not m_havefirstevent) {
-                m_havefirstevent = true;
-            } else {
-                flush();
-                m_isstart = true;
+            try {
+                apply(record);
+            } catch (...) {
+                m_error = std::current_exception();
+                m_failed.store(true, std::memory_order_release);
             }
         }
-        m_buffer.set(it->second, std::move(value));
-        m_valid[it->second] = true;
 
-        m_newbagwatcher[name] = time;
+        m_head.store(++head);
+        if (m_waiting.load()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_space.notify_one();
+        }
+
+        if (not running)
+            return;
     }
-    m_time = time;
 }
 
-std::unique_ptr<value::Matrix>
-File::finish(const double& time)
+void
+File::apply(const Record& record)
 {
-    // build the final file
-    finalFlush(time);
-    std::vector<std::string> array(m_columns.size());
+    std::unique_ptr<value::Value> value(record.value);
+
+    switch (record.type) {
+    case Record::NEW_COLUMN:
+        newColumn(value->toString().value(), record.time);
+        break;
+    case Record::REAL:
+        onColumnReal(record.column, record.time, record.real);
+        m_time = record.time;
+        break;
+    case Record::VALUE:
+        onColumnValue(record.column, record.time, std::move(value));
+        m_time = record.time;
+        break;
+    case Record::TIME:
+        m_time = record.time;
+        break;
+    case Record::FINISH:
+        close(record.time);
+        break;
+    case Record::STOP:
+        break;
+    }
+}
 
-    auto it = m_columns.begin();
-    for (it = m_columns.begin(); it != m_columns.end(); ++it) {
-        array[it->second] = it->first;
+void
+File::newColumn(const std::string& name, double time)
+{
+    if (m_isstart) {
+        flush();
+    } else {
+        if (not m_havefirstevent) {
+            m_time = time;
+            m_havefirstevent = true;
+        } else {
+            flush();
+            m_isstart = true;
+        }
     }
-    m_file << "\n";
-    m_file.close();
 
-    if (m_type == File::FILE) {
-        copyToFile(m_filename, array);
+    m_names.push_back(name);
+    m_newbagwatcher.push_back(-1.0);
+    m_buffer.add(std::unique_ptr<value::Value>());
+    m_reals.push_back(0.0);
+    m_isreal.push_back(false);
+    m_valid.push_back(false);
+}
+
+void
+File::onColumnValue(std::size_t column,
+                    double time,
+                    std::unique_ptr<value::Value> value)
+{
+    nextValue(column, time);
+    m_buffer.set(column, std::move(value));
+    m_isreal[column] = false;
+    m_valid[column] = true;
+
+    m_newbagwatcher[column] = time;
+}
+
+void
+File::onColumnReal(std::size_t column, double time, double value)
+{
+    nextValue(column, time);
+    if (m_buffer[column])
+        m_buffer.set(column, std::unique_ptr<value::Value>());
+    m_reals[column] = value;
+    m_isreal[column] = true;
+    m_valid[column] = true;
+
+    m_newbagwatcher[column] = time;
+}
+
+void
+File::nextValue(std::size_t column, double time)
+{
+    if (m_isstart) {
+        if (time != m_time ||
+            (m_flushbybag && m_newbagwatcher[column] == time)) {
+            flush();
+        }
     } else {
-        copyToStream((m_type == File::STANDARD_OUT) ? std::cout : std::cerr,
-                     array);
+        if (not m_havefirstevent) {
+            m_havefirstevent = true;
+        } else {
+            flush();
+            m_isstart = true;
+        }
+    }
+}
+
+std::unique_ptr<value::Matrix>
+File::finish(const double& time)
+{
+    if (m_writer.joinable()) {
+        push({ Record::FINISH, 0, time, 0.0, nullptr });
+        m_writer.join();
+
+        if (m_failed.load())
+            std::rethrow_exception(m_error);
+    } else {
+        close(time);
     }
-    std::remove(m_filenametmp.c_str());
 
     return {};
 }
 
+void
+File::close(double time)
+{
+    finalFlush(time);
+
+    if (not m_havehead)
+        writeHeadIfNeeded();
+
+    // Two empty lines end the output, as the copy of the temporary file
+    // did in previous versions.
+    m_stream << "\n\n";
+    m_stream.flush();
+
+    if (m_type == File::FILE) {
+        m_file.close();
+
+        if (m_headcolumns != m_names.size())
+            rewriteHead();
+    }
+}
+
 void
 File::flush()
 {
     if (m_valid.empty() or
         std::find(m_valid.begin(), m_valid.end(), true) != m_valid.end()) {
-        m_file << m_time;
+        writeHeadIfNeeded();
+
+        m_stream << m_time;
         if (m_julian) {
-            m_filetype->writeSeparator(m_file);
+            m_filetype->writeSeparator(m_stream);
             try {
-                m_file << utils::DateTime::toJulianDay(m_time);
+                m_stream << utils::DateTime::toJulianDay(m_time);
             } catch (const std::exception& /*e*/) {
                 throw utils::ModellingError(
                   "Output plug-in: Year is out of valid range "
                   "in julian day: 1400..10000");
             }
         }
-        m_filetype->writeSeparator(m_file);
+        m_filetype->writeSeparator(m_stream);
 
         const size_t nb(m_buffer.size());
         for (size_t i = 0; i < nb; ++i) {
-            if (m_buffer[i]) {
-                m_buffer[i]->writeFile(m_file);
-            } else {
-                m_file << "NA";
-            }
+            writeCell(i);
 
             if (i + 1 < nb) {
-                m_filetype->writeSeparator(m_file);
+                m_filetype->writeSeparator(m_stream);
             }
             m_valid[i] = false;
         }
-        m_file << "\n";
+        m_stream << "\n";
     }
 }
 
@@ -300,71 +547,107 @@ File::finalFlush(double trame_time)
     flush();
 
     if (std::find(m_valid.begin(), m_valid.end(), true) != m_valid.end()) {
-        m_file << trame_time;
+        writeHeadIfNeeded();
+
+        m_stream << trame_time;
         if (m_julian) {
-            m_filetype->writeSeparator(m_file);
+            m_filetype->writeSeparator(m_stream);
             try {
-                m_file << utils::DateTime::toJulianDay(m_time);
+                m_stream << utils::DateTime::toJulianDay(m_time);
             } catch (const std::exception& /*e*/) {
                 throw utils::ModellingError(
                   "Output plug-in: Year is out of valid range "
                   "in julian day: 1400..10000");
             }
         }
-        m_filetype->writeSeparator(m_file);
-        for (auto it = m_buffer.begin(); it != m_buffer.end(); ++it) {
-            if (*it) {
-                (*it)->writeFile(m_file);
-            } else {
-                m_file << "NA";
-            }
+        m_filetype->writeSeparator(m_stream);
+        const size_t nb(m_buffer.size());
+        for (size_t i = 0; i < nb; ++i) {
+            writeCell(i);
 
-            if (it + 1 != m_buffer.end()) {
-                m_filetype->writeSeparator(m_file);
+            if (i + 1 < nb) {
+                m_filetype->writeSeparator(m_stream);
             }
         }
-        m_file << "\n";
+        m_stream << "\n";
         m_buffer.clear();
+        m_reals.clear();
+        m_isreal.clear();
     }
 }
 
 void
-File::copyToFile(const std::string& filename,
-                 const std::vector<std::string>& array)
+File::writeCell(std::size_t column)
 {
-    std::ofstream file(filename.c_str());
-
-    std::vector<std::string> tmp(array);
-    if (m_julian) {
-        tmp.insert(tmp.begin(), "julian-day");
-    }
-    tmp.insert(tmp.begin(), "time");
-    m_filetype->writeHead(file, tmp);
-
-    std::ifstream tmpfile(m_filenametmp.c_str());
-    std::string tmpbuffer;
-    while (tmpfile) {
-        std::getline(tmpfile, tmpbuffer);
-        file << tmpbuffer << '\n';
+    if (m_isreal[column]) {
+        m_stream << m_reals[column];
+    } else if (m_buffer[column]) {
+        m_buffer[column]->writeFile(m_stream);
+    } else {
+        m_stream << "NA";
     }
 }
 
 void
-File::copyToStream(std::ostream& stream, const std::vector<std::string>& array)
+File::writeHeadIfNeeded()
 {
-    std::vector<std::string> tmp(array);
-    if (m_julian) {
-        tmp.insert(tmp.begin(), "julian-day");
+    if (m_havehead and
+        (m_headcolumns == m_names.size() or m_type == File::FILE))
+        return;
+
+    m_filetype->writeHead(m_stream, heads());
+    m_headcolumns = m_names.size();
+    m_havehead = true;
+}
+
+File::Strings
+File::heads() const
+{
+    Strings result(m_names);
+
+    if (m_julian)
+        result.insert(result.begin(), "julian-day");
+
+    result.insert(result.begin(), "time");
+
+    return result;
+}
+
+void
+File::rewriteHead()
+{
+    if (std::rename(m_filename.c_str(), m_filenametmp.c_str()))
+        throw utils::FileError("Output plug-in: cannot rename file '%s'",
+                               m_filename.c_str());
+
+    bool success = false;
+
+    {
+        std::ifstream tmpfile(m_filenametmp.c_str(), std::ios::binary);
+        std::ofstream file(m_filename.c_str(), std::ios::binary);
+
+        if (tmpfile.is_open() and file.is_open()) {
+            std::string oldhead;
+            std::getline(tmpfile, oldhead);
+
+            m_filetype->writeHead(file, heads());
+            if (tmpfile.peek() != std::char_traits<char>::eof())
+                file << tmpfile.rdbuf();
+
+            file.flush();
+            success = not tmpfile.bad() and file.good();
+        }
     }
-    tmp.insert(tmp.begin(), "time");
-    m_filetype->writeHead(stream, tmp);
-
-    std::ifstream tmpfile(m_filenametmp.c_str());
-    std::string tmpbuffer;
-    while (tmpfile) {
-        std::getline(tmpfile, tmpbuffer);
-        stream << tmpbuffer << '\n';
+
+    if (not success) {
+        std::remove(m_filename.c_str());
+        std::rename(m_filenametmp.c_str(), m_filename.c_str());
+        throw utils::FileError("Output plug-in: cannot write the header of "
+                               "file '%s'",
+                               m_filename.c_str());
     }
+
+    std::remove(m_filenametmp.c_str());
 }
 
 std::string
@@ -30,9 +30,14 @@
 #include <vle/oov/Plugin.hpp>
 #include <vle/value/Set.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <fstream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace vle {
@@ -42,9 +47,17 @@ namespace plugin {
 /**
  * @brief File is a virtual class for the csv, text, and rdata
  * plug-in.
- * When simulation is running, File writes information into a
- * tempory file localized into the local directory or in the directory
- * specified in the parameter trame.
+ * When simulation is running, File writes information directly into the
+ * file localized into the local directory or in the directory specified
+ * in the parameter trame, through a large buffer. The header is written
+ * before the first row with the observables known at this date. If an
+ * observable is added after, the file is copied behind the header of all
+ * the observables at the end of the simulation (the header is written
+ * again before the next row for the standard and error outputs).
+ * For the file output, the rows are formatted and written by a writer
+ * thread: the simulation only pushes the observed values into a bounded
+ * queue and waits if the queue is full. The queue is emptied and the
+ * file is complete when finish returns.
  * The File accepts a value::Map in parameter with two keys:
  * - out: define the type of output. By default, it uses and file. But if
  *   the value equal 'out', it copy result into the standard output and if
@@ -56,6 +69,8 @@ namespace plugin {
  *   command to show all locale of your system.
  * - flush-by-bag: If the value is true, an output is provided for
  * each bag.
+ * - asynchronous: If the value is false, the file output is written by
+ *   the simulation thread. Default is true.
  * <map>
  *  <key name="output">
  *   <string>out</string> <!-- or 'error' -->
@@ -76,6 +91,9 @@ public:
      */
     using Strings = std::vector<std::string>;
 
+    /** Number of records of the queue (a power of two). */
+    static constexpr std::size_t queue_size = 1 << 16;
+
     File(const std::string& location);
 
     ~File() override;
@@ -96,6 +114,12 @@ public:
                          const std::string& view,
                          const double& time) override;
 
+    std::int32_t onNewObservableHandle(const std::string& simulator,
+                                       const std::string& parent,
+                                       const std::string& port,
+                                       const std::string& view,
+                                       const double& time) override;
+
     void onDelObservable(const std::string& simulator,
                          const std::string& parent,
                          const std::string& port,
@@ -109,6 +133,14 @@ public:
                  const double& time,
                  std::unique_ptr<value::Value> value) override;
 
+    void onHandleValue(std::int32_t handle,
+                       const double& time,
+                       std::unique_ptr<value::Value> value) override;
+
+    void onHandleReal(std::int32_t handle,
+                      const double& time,
+                      double value) override;
+
     std::unique_ptr<value::Matrix> finish(const double& time) override;
 
     class FileType
@@ -129,14 +161,12 @@ private:
     /** Define a dictionary (model's name, index) */
     typedef std::map<std::string, std::size_t> Columns;
 
-    /** Define the buffer of values. */
-    using Line = std::vector<value::Value*>;
-
     /** Define the buffer for valid values (model observed). */
     using ValidElement = std::vector<bool>;
 
-    /** Define a new bag indicator*/
-    typedef std::map<std::string, double> NewBagWatcher;
+    /** Define a new bag indicator (date of the last value of each
+     * column). */
+    using NewBagWatcher = std::vector<double>;
 
     enum OutputType
     {
@@ -145,30 +175,152 @@ private:
         STANDARD_ERROR /*!< use the error output (std::cerr). */
     };
 
+    /**
+     * @brief An event of the simulation sent to the writer: the values
+     * are owned by the record until they are stored into the row buffer.
+     */
+    struct Record
+    {
+        enum Type
+        {
+            NEW_COLUMN, /*!< the observable @e column is added. */
+            REAL,       /*!< the real @e real of the @e column. */
+            VALUE,      /*!< the value @e value of the @e column. */
+            TIME,       /*!< a value without observable. */
+            FINISH,     /*!< end of the simulation, @e time is the end. */
+            STOP        /*!< the plug-in is destroyed. */
+        };
+
+        Type type;
+        std::size_t column;
+        double time;
+        double real;
+        value::Value* value;
+    };
+
+    /** Size of the buffer of the file stream. */
+    static constexpr std::size_t buffer_size = 1 << 20;
+
+    /** Size of the cache line used to pad the indices of the queue. */
+    static constexpr std::size_t cache_line_size = 64;
+
     std::unique_ptr<FileType> m_filetype;
-    Columns m_columns;
+    Columns m_columns; /*!< used by the simulation thread only. */
+    Strings m_names;   /*!< names of the columns known by the writer. */
     value::Set m_buffer;
+    std::vector<double> m_reals; /*!< reals of the row (null in m_buffer). */
+    ValidElement m_isreal;
     ValidElement m_valid;
     NewBagWatcher m_newbagwatcher;
     double m_time;
+    std::vector<char> m_filebuffer;
     std::ofstream m_file;
+    std::ostream m_stream; /*!< writes into m_file, std::cout or std::cerr. */
     std::string m_filename;
     std::string m_filenametmp;
+    std::size_t m_headcolumns; /*!< number of columns of the header. */
+    bool m_havehead;
     bool m_isstart;
     bool m_havefirstevent;
     bool m_julian;
     OutputType m_type;
     bool m_flushbybag;
+    bool m_asynchronous;
+
+    /*
+     * Single producer (the simulation) and single consumer (the writer)
+     * queue of records: m_head is only written by the writer and m_tail by
+     * the simulation. They are padded to lie in different cache lines
+     * without over-aligning the plug-in.
+     */
+    std::vector<Record> m_queue;
+    char m_padhead[cache_line_size];
+    std::atomic<std::size_t> m_head;
+    char m_padtail[cache_line_size - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> m_tail;
+    char m_padend[cache_line_size - sizeof(std::atomic<std::size_t>)];
+    std::atomic<bool> m_sleeping; /*!< the writer waits for a record. */
+    std::atomic<bool> m_waiting;  /*!< the simulation waits for a slot. */
+    std::atomic<bool> m_failed;
+    std::exception_ptr m_error; /*!< set by the writer before m_failed. */
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup; /*!< a record is pushed. */
+    std::condition_variable m_space;  /*!< a record is released. */
+    std::thread m_writer;
+
+    /**
+     * @brief Send a record to the writer or, if there is no writer thread,
+     * apply it. If the queue is full, wait for the writer.
+     * @throw the exception thrown by the writer.
+     */
+    void post(const Record& record);
+
+    /**
+     * @brief Send a record to the writer without checking its errors.
+     */
+    void push(const Record& record);
+
+    /**
+     * @brief The loop of the writer thread, until a FINISH or STOP record.
+     */
+    void write();
+
+    /**
+     * @brief Update the row buffer and the output with a record and
+     * release its value.
+     */
+    void apply(const Record& record);
+
+    void newColumn(const std::string& name, double time);
+
+    void writeCell(std::size_t column);
 
     void flush();
 
-    void finalFlush(double trame_time);
+    /**
+     * @brief Write the header before a row if it is not written or if
+     * observables are added since (standard and error outputs).
+     */
+    void writeHeadIfNeeded();
 
-    void copyToFile(const std::string& filename,
-                    const std::vector<std::string>& array);
+    /**
+     * @brief Build the header: time, julian-day and the observables.
+     */
+    Strings heads() const;
+
+    /**
+     * @brief Store the @e value of the column @e column at date @e time.
+     */
+    void onColumnValue(std::size_t column,
+                       double time,
+                       std::unique_ptr<value::Value> value);
 
-    void copyToStream(std::ostream& out,
-                      const std::vector<std::string>& array);
+    /**
+     * @brief Store the real @e value of the column @e column at date
+     * @e time.
+     */
+    void onColumnReal(std::size_t column, double time, double value);
+
+    /**
+     * @brief Flush the row if the value of the column @e column at date
+     * @e time starts a new row.
+     */
+    void nextValue(std::size_t column, double time);
+
+    /**
+     * @brief Write the last row and the end of the output.
+     */
+    void close(double time);
+
+    void finalFlush(double trame_time);
+
+    /**
+     * @brief Replace the header of the file with the header of all the
+     * observables.
+     * @throw utils::FileError if the file cannot be updated, the previous
+     * file is kept.
+     */
+    void rewriteHead();
 
     /**
      * @brief This function is use to build uniq name to each row of the
@@ -25,6 +25,9 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <list>
 #include <map>
 #include <memory>
@@ -35,7 +38,10 @@
 #include <vle/value/Double.hpp>
 #include <vle/value/Map.hpp>
 #include <vle/value/Matrix.hpp>
+#include <vle/value/Null.hpp>
+#include <vle/value/Set.hpp>
 #include <vle/value/String.hpp>
+#include <vle/value/Tuple.hpp>
 
 namespace vle {
 namespace oov {
@@ -72,6 +78,19 @@ enum StorageHeaderType
                           * the matrix results. */
 };
 
+/**
+ * The storage plug-in builds a matrix with a column per observable (and
+ * the first column for the dates) and a row per date.
+ *
+ * With the \e columnar parameter set to true, the values are not stored
+ * into the cells of the matrix during the simulation but into a \e
+ * std::vector<double> per column. The result is a matrix of one row
+ * (after the optional header): a \e value::Tuple of all the reals of each
+ * column, moved without copy, where the missing values are NaN. A column
+ * becomes a \e value::Set of values, where the missing values are \e
+ * value::Null, when a value which is not a real or a NaN real is observed,
+ * so a NaN of a \e value::Tuple is always a missing value.
+ */
 class Storage : public Plugin
 {
 public:
@@ -80,6 +99,7 @@ public:
       , m_matrix(nullptr)
       , m_time(devs::negativeInfinity)
       , m_headertype(STORAGE_HEADER_NONE)
+      , m_columnar(false)
     {}
 
     /**
@@ -96,6 +116,9 @@ public:
      */
     std::unique_ptr<value::Matrix> matrix() const override
     {
+        if (m_columnar) {
+            return columnarMatrix();
+        }
         if (m_matrix) {
             return std::make_unique<value::Matrix>(*m_matrix);
         }
@@ -137,8 +160,16 @@ public:
                 }
             }
 
+            if (map.exist("columnar")) {
+                m_columnar = map.getBoolean("columnar");
+            }
+
             parameters.reset();
         }
+        if (m_columnar) {
+            return;
+        }
+
         if (m_headertype == STORAGE_HEADER_TOP) {
             m_matrix = std::make_unique<value::Matrix>(
               1, 1, rzcolumns, rzrows, rzcolumns, rzrows);
@@ -155,10 +186,28 @@ public:
     void onNewObservable(const std::string& simulator,
                          const std::string& parent,
                          const std::string& port,
-                         const std::string& /*view*/,
-                         const double& /*time*/) override
+                         const std::string& view,
+                         const double& time) override
+    {
+        onNewObservableHandle(simulator, parent, port, view, time);
+    }
+
+    std::int32_t onNewObservableHandle(const std::string& simulator,
+                                       const std::string& parent,
+                                       const std::string& port,
+                                       const std::string& /*view*/,
+                                       const double& /*time*/) override
     {
         std::string key = buildKey(parent, simulator, port);
+
+        if (m_columnar) {
+            Index idx = m_columns.size() + 1;
+            m_colAccess.insert(std::make_pair(key, idx));
+            m_columns.emplace_back();
+            m_columns.back().name = key;
+            return static_cast<std::int32_t>(idx);
+        }
+
         Index idx = m_matrix->columns();
 
         m_colAccess.insert(std::make_pair(key, m_matrix->columns()));
@@ -171,6 +220,8 @@ public:
               0,
               std::unique_ptr<value::Value>(new vle::value::String(key)));
         }
+
+        return static_cast<std::int32_t>(idx);
     }
 
     void onDelObservable(const std::string& /*simulator*/,
@@ -193,29 +244,238 @@ public:
             std::string key = buildKey(parent, simulator, port);
 
             MapPairIndex::const_iterator it = m_colAccess.find(key);
-            m_matrix->set(it->second, m_matrix->rows() - 1, std::move(value));
+            if (m_columnar) {
+                setValue(m_columns[it->second - 1], std::move(value));
+            } else {
+                m_matrix->set(
+                  it->second, m_matrix->rows() - 1, std::move(value));
+            }
+        }
+    }
+
+    void onHandleValue(std::int32_t handle,
+                       const double& time,
+                       std::unique_ptr<value::Value> value) override
+    {
+        nextTime(time);
+
+        if (m_columnar) {
+            setValue(m_columns[handle - 1], std::move(value));
+        } else {
+            m_matrix->set(handle, m_matrix->rows() - 1, std::move(value));
         }
     }
 
+    void onHandleReal(std::int32_t handle,
+                      const double& time,
+                      double value) override
+    {
+        if (not m_columnar) {
+            Plugin::onHandleReal(handle, time, value);
+            return;
+        }
+
+        nextTime(time);
+
+        Column& column = m_columns[handle - 1];
+        column.resize(m_times.size());
+        column.setReal(m_times.size() - 1, value);
+    }
+
     std::unique_ptr<value::Matrix> finish(const double& /*time*/) override
     {
-        return std::move(m_matrix);
+        if (not m_columnar) {
+            return std::move(m_matrix);
+        }
+
+        auto result = columnarHeader();
+        Index row = result->rows() - 1;
+        std::size_t rows = m_times.size();
+
+        auto times = std::make_unique<value::Tuple>();
+        times->value().swap(m_times);
+        result->set(0, row, std::move(times));
+
+        for (Index i = 0; i < m_columns.size(); ++i)
+            result->set(i + 1, row, m_columns[i].give(rows));
+
+        m_columns.clear();
+        return result;
     }
 
 private:
+    /**
+     * A column of the columnar mode: the \e reals, where NaN is a missing
+     * value, or, once a value which is not a real or a NaN real is
+     * observed, the \e values. A column is extended with missing values up
+     * to the row of the observed value.
+     */
+    struct Column
+    {
+        std::string name;
+        std::vector<double> reals;
+        std::vector<std::unique_ptr<value::Value>> values;
+        bool boxed = false;
+
+        std::size_t size() const
+        {
+            return boxed ? values.size() : reals.size();
+        }
+
+        void resize(std::size_t rows)
+        {
+            if (size() >= rows)
+                return;
+
+            if (boxed) {
+                values.resize(rows);
+            } else {
+                reals.resize(rows, std::numeric_limits<double>::quiet_NaN());
+            }
+        }
+
+        void setReal(std::size_t row, double value)
+        {
+            if (not boxed and std::isnan(value))
+                box();
+
+            if (boxed)
+                values[row] = value::Double::create(value);
+            else
+                reals[row] = value;
+        }
+
+        void setValue(std::size_t row, std::unique_ptr<value::Value> value)
+        {
+            if (not boxed and value and value->isDouble()) {
+                setReal(row, value->toDouble().value());
+            } else if (not boxed and not value) {
+                reals[row] = std::numeric_limits<double>::quiet_NaN();
+            } else {
+                if (not boxed)
+                    box();
+                values[row] = std::move(value);
+            }
+        }
+
+        /**
+         * Moves the reals into \e values to store values which are not
+         * reals.
+         */
+        void box()
+        {
+            values.resize(reals.size());
+            for (std::size_t i = 0, e = reals.size(); i != e; ++i)
+                if (not std::isnan(reals[i]))
+                    values[i] = value::Double::create(reals[i]);
+
+            std::vector<double>().swap(reals);
+            boxed = true;
+        }
+
+        /**
+         * Moves the column into a \e value::Tuple or a \e value::Set of
+         * \e rows elements.
+         */
+        std::unique_ptr<value::Value> give(std::size_t rows)
+        {
+            resize(rows);
+
+            if (not boxed) {
+                auto result = std::make_unique<value::Tuple>();
+                result->value().swap(reals);
+                return std::unique_ptr<value::Value>(std::move(result));
+            }
+
+            auto result = std::make_unique<value::Set>();
+            for (auto& elem : values)
+                if (not elem)
+                    elem = value::Null::create();
+            result->value().swap(values);
+            return std::unique_ptr<value::Value>(std::move(result));
+        }
+
+        /**
+         * Copies the column into a \e value::Tuple or a \e value::Set of
+         * \e rows elements.
+         */
+        std::unique_ptr<value::Value> clone(std::size_t rows) const
+        {
+            if (not boxed) {
+                auto result = std::make_unique<value::Tuple>(
+                  rows, std::numeric_limits<double>::quiet_NaN());
+                std::copy(reals.begin(), reals.end(), result->value().begin());
+                return std::unique_ptr<value::Value>(std::move(result));
+            }
+
+            auto result = std::make_unique<value::Set>();
+            for (const auto& elem : values)
+                result->add(elem ? elem->clone() : value::Null::create());
+            for (std::size_t i = values.size(); i < rows; ++i)
+                result->add(value::Null::create());
+            return std::unique_ptr<value::Value>(std::move(result));
+        }
+    };
+
     std::unique_ptr<value::Matrix> m_matrix;
     MapPairIndex m_colAccess;
     double m_time;
     StorageHeaderType m_headertype;
+    bool m_columnar;
+    std::vector<double> m_times;
+    std::vector<Column> m_columns;
 
     inline void nextTime(double trame_time)
     {
         if (trame_time != m_time) {
             m_time = trame_time;
-            setLastTime();
+            if (m_columnar)
+                m_times.push_back(m_time);
+            else
+                setLastTime();
         }
     }
 
+    void setValue(Column& column, std::unique_ptr<value::Value> value)
+    {
+        column.resize(m_times.size());
+        column.setValue(m_times.size() - 1, std::move(value));
+    }
+
+    /**
+     * Build the result of the columnar mode with the optional header and
+     * an empty row for the columns.
+     */
+    std::unique_ptr<value::Matrix> columnarHeader() const
+    {
+        Index header = m_headertype == STORAGE_HEADER_TOP ? 1 : 0;
+        auto result = std::make_unique<value::Matrix>(
+          m_columns.size() + 1, header + 1, 1, 1);
+
+        if (header) {
+            result->set(0, 0, value::String::create("time"));
+            for (Index i = 0; i < m_columns.size(); ++i)
+                result->set(
+                  i + 1, 0, value::String::create(m_columns[i].name));
+        }
+
+        return result;
+    }
+
+    std::unique_ptr<value::Matrix> columnarMatrix() const
+    {
+        auto result = columnarHeader();
+        Index row = result->rows() - 1;
+
+        auto times = std::make_unique<value::Tuple>();
+        times->value() = m_times;
+        result->set(0, row, std::move(times));
+        for (Index i = 0; i < m_columns.size(); ++i)
+            result->set(i + 1, row, m_columns[i].clone(m_times.size()));
+
+        return result;
+    }
+
     inline void setLastTime()
     {
         value::Matrix::size_type row(m_matrix->rows());
@@ -42,6 +42,7 @@
 
 #include <boost/bind.hpp>
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 
@@ -78,11 +79,18 @@ namespace devs {
 Coordinator::Coordinator(utils::ContextPtr context,
                          const vpz::Dynamics& dyn,
                          const vpz::Classes& cls,
-                         const vpz::Experiment& experiment)
+                         const vpz::Experiment& experiment,
+                         std::shared_ptr<ModelSymbols> symbols)
   : m_context(context)
   , m_currentTime(0.0)
   , m_simulators_thread_pool(m_context)
-  , m_modelFactory(context, m_eventViewList, dyn, cls, experiment)
+  , m_eventTable(m_context)
+  , m_modelFactory(context,
+                   m_eventViewList,
+                   dyn,
+                   cls,
+                   experiment,
+                   std::move(symbols))
   , m_isStarted(false)
 {}
 
@@ -112,17 +120,36 @@ Coordinator::run()
 
     m_context->debug(_("-------- BAG [%f] --------\n"), m_currentTime);
 
+    //
+    // Rebuild the routing tables of the simulators whose connections
+    // changed since the last bag (new models, executive graph changes).
+    //
+
+    if (not m_dirty_routes.empty())
+        updateRoutes();
+
     //
     // Call output functions for all executives and dynamics models then
-    // dispatches external events for all executives and dynamics.
+    // dispatches external events for all executives and dynamics. Output
+    // functions of dynamics models are computed in parallel if available
+    // but external events are dispatched sequentially, in the order of the
+    // bag, to get the same results than the sequential kernel.
     //
 
     const std::size_t nb_dynamics = bag.dynamics.size();
     const std::size_t nb_executive = bag.executives.size();
 
     if (nb_dynamics > 0) {
-        for (std::size_t i = 0; i != nb_dynamics; ++i)
-            bag.dynamics[i]->output(m_currentTime);
+        if (m_simulators_thread_pool.parallelize()) {
+            const Time time = m_currentTime;
+            m_simulators_thread_pool.for_each(
+              bag.dynamics,
+              m_output_estimator,
+              [time](Simulator* simulator) { simulator->output(time); });
+        } else {
+            for (std::size_t i = 0; i != nb_dynamics; ++i)
+                bag.dynamics[i]->output(m_currentTime);
+        }
 
         dispatchExternalEvent(bag.dynamics, nb_dynamics);
     }
@@ -153,7 +180,8 @@ Coordinator::run()
     // linearly.
     //
     if (m_simulators_thread_pool.parallelize()) {
-        m_simulators_thread_pool.for_each(bag.dynamics, m_currentTime);
+        m_simulators_thread_pool.for_each(
+          bag.dynamics, m_transition_estimator, m_currentTime);
     } else {
         for (auto& elem : bag.dynamics) {
             if (elem->haveInternalEvent()) {
@@ -197,10 +225,7 @@ Coordinator::run()
     for (auto& elem : bag.dynamics) {
         auto& observations = elem->getObservations();
         for (auto& obs : observations)
-            obs.view->run(elem->dynamics().get(),
-                          m_currentTime,
-                          obs.portname,
-                          std::move(obs.value));
+            obs.view->run(elem->dynamics().get(), m_currentTime, obs);
 
         observations.clear();
     }
@@ -208,10 +233,7 @@ Coordinator::run()
     for (auto& elem : bag.executives) {
         auto& observations = elem->getObservations();
         for (auto& obs : observations)
-            obs.view->run(elem->dynamics().get(),
-                          m_currentTime,
-                          obs.portname,
-                          std::move(obs.value));
+            obs.view->run(elem->dynamics().get(), m_currentTime, obs);
 
         observations.clear();
     }
@@ -346,16 +368,17 @@ Coordinator::dynamic_deletion()
     for (auto& elem : lst) {
         m_eventTable.delSimulator(elem);
 
+        if (elem->haveDirtyRoutes())
+            m_dirty_routes.erase(std::find(
+              m_dirty_routes.begin(), m_dirty_routes.end(), elem));
+
         for (auto it = m_simulators.begin(), et = m_simulators.end(); it != et;
              ++it) {
             if (it->get() == elem) {
                 elem->finish();
                 auto& observations = elem->getObservations();
                 for (auto& obs : observations)
-                    obs.view->run(elem->dynamics().get(),
-                                  m_currentTime,
-                                  obs.portname,
-                                  std::move(obs.value));
+                    obs.view->run(elem->dynamics().get(), m_currentTime, obs);
 
                 observations.clear();
                 m_simulators.erase(it);
@@ -403,7 +426,7 @@ Coordinator::updateSimulatorsTarget(
     if (m_isStarted) {
         for (auto& elem : lst) {
             if (elem.first != nullptr) {
-                elem.first->updateSimulatorTargets(elem.second);
+                setDirtyRoutes(elem.first);
             }
         }
     }
@@ -411,9 +434,9 @@ Coordinator::updateSimulatorsTarget(
 
 void
 Coordinator::removeSimulatorTargetPort(vpz::AtomicModel* model,
-                                       const std::string& port)
+                                       const std::string& /*port*/)
 {
-    model->get_simulator()->removeTargetPort(port);
+    setDirtyRoutes(model->get_simulator());
 }
 
 Simulator*
@@ -422,6 +445,7 @@ Coordinator::addModel(vpz::AtomicModel* model)
     assert(model && "Coordinator: nullptr model to add?");
 
     m_simulators.emplace_back(std::make_unique<Simulator>(model));
+    setDirtyRoutes(m_simulators.back().get());
 
     return m_simulators.back().get();
 }
@@ -466,6 +490,24 @@ Coordinator::addModels(const vpz::Model& model)
     m_modelFactory.createModels(*this, model);
 }
 
+void
+Coordinator::setDirtyRoutes(Simulator* simulator)
+{
+    if (not simulator->haveDirtyRoutes()) {
+        simulator->setDirtyRoutes();
+        m_dirty_routes.emplace_back(simulator);
+    }
+}
+
+void
+Coordinator::updateRoutes()
+{
+    for (auto* simulator : m_dirty_routes)
+        simulator->updateRoutes(m_port_names);
+
+    m_dirty_routes.clear();
+}
+
 void
 Coordinator::dispatchExternalEvent(std::vector<Simulator*>& simulators,
                                    const std::size_t number)
@@ -475,15 +517,13 @@ Coordinator::dispatchExternalEvent(std::vector<Simulator*>& simulators,
             continue;
 
         auto& eventList = simulators[i]->result();
-        for (auto& elem : eventList) {
-            auto x = simulators[i]->targets(elem.getPortName());
+        auto& routes = simulators[i]->result_routes();
+        assert(eventList.size() == routes.size());
 
-            if (x.first != x.second and x.first->second.first) {
-                for (auto jt = x.first; jt != x.second; ++jt)
-                    m_eventTable.addExternal(
-                      jt->second.first, elem.attributes(), jt->second.second);
-            }
-        }
+        for (std::size_t j = 0, e = eventList.size(); j != e; ++j)
+            for (auto it = routes[j].first; it != routes[j].second; ++it)
+                m_eventTable.addExternal(
+                  it->simulator, eventList[j], m_port_names[it->port]);
 
         simulators[i]->clear_result();
     }
@@ -573,15 +613,28 @@ Coordinator::processInit(Simulator* simulator)
 std::unique_ptr<value::Map>
 Coordinator::finish()
 {
+    if (m_simulators_thread_pool.parallelize()) {
+        auto stats = m_simulators_thread_pool.statistics();
+
+        m_context->info(_("Simulation kernel: jobs:%llu sequential:%llu "
+                          "small:%llu block-size:%f blocks:%llu "
+                          "steals:%llu parks:%llu idle:%fs\n"),
+                        static_cast<unsigned long long>(stats.jobs),
+                        static_cast<unsigned long long>(stats.sequential),
+                        static_cast<unsigned long long>(stats.small),
+                        stats.block_size,
+                        static_cast<unsigned long long>(stats.blocks),
+                        static_cast<unsigned long long>(stats.steals),
+                        static_cast<unsigned long long>(stats.parks),
+                        stats.idle);
+    }
+
     for (auto& elem : m_simulators) {
         assert(elem.get());
         elem->finish();
         auto& observations = elem->getObservations();
         for (auto& obs : observations)
-            obs.view->run(elem->dynamics().get(),
-                          m_currentTime,
-                          obs.portname,
-                          std::move(obs.value));
+            obs.view->run(elem->dynamics().get(), m_currentTime, obs);
 
         observations.clear();
     }
@@ -54,7 +54,8 @@ public:
     Coordinator(utils::ContextPtr context,
                 const vpz::Dynamics& dyn,
                 const vpz::Classes& cls,
-                const vpz::Experiment& experiment);
+                const vpz::Experiment& experiment,
+                std::shared_ptr<ModelSymbols> symbols = nullptr);
 
     ~Coordinator() = default;
 
@@ -262,6 +263,18 @@ public:
      */
     std::unique_ptr<value::Map> finish();
 
+    /**
+     * Retrieves the statistics of the thread pool used to compute the
+     * bags: number of bags computed in parallel or sequentially, mean
+     * block size, etc.
+     *
+     * @return The statistics or zero if the simulation is sequential.
+     */
+    SimulatorProcessStatistics statistics() const noexcept
+    {
+        return m_simulators_thread_pool.statistics();
+    }
+
     /**
      * Retrives access to all event (output, internal, external, ...) \e
      * Views.
@@ -283,6 +296,18 @@ public:
      */
     void dynamic_deletion();
 
+    /**
+     * Add the \e simulator to the list of simulators whose routing table
+     * must be rebuild before the next bag.
+     */
+    void setDirtyRoutes(Simulator* simulator);
+
+    /**
+     * Rebuild the routing tables of the simulators of the \e
+     * m_dirty_routes list.
+     */
+    void updateRoutes();
+
 private:
     Coordinator(const Coordinator& other);
     Coordinator& operator=(const Coordinator& other);
@@ -291,6 +316,8 @@ private:
     Time m_currentTime;
     Time m_durationTime;
     SimulatorProcessParallel m_simulators_thread_pool;
+    SimulatorProcessEstimator m_output_estimator;
+    SimulatorProcessEstimator m_transition_estimator;
     std::vector<std::unique_ptr<Simulator>> m_simulators;
     Scheduler m_eventTable;
     TimedObservationScheduler m_timed_observation_scheduler;
@@ -300,6 +327,9 @@ private:
 
     std::vector<vpz::BaseModel*> m_delete_model;
 
+    PortNames m_port_names;
+    std::vector<Simulator*> m_dirty_routes;
+
     bool m_isStarted;
 
     /**
@@ -188,6 +188,24 @@ DynamicsDbg::observation(const ObservationEvent& event) const
     return mDynamics->observation(event);
 }
 
+void
+DynamicsDbg::scalarObservation(const ObservationEvent& event,
+                               ScalarObservation& value) const
+{
+    assert(mDynamics && "DynamicsDbg: missing set(Dynamics)");
+
+    mDynamics->scalarObservation(event, value);
+
+    if (value)
+        context()->debug(_("%.*g %s [DEVS] scalar observation: [from: '%s'"
+                           " port: '%s']\n"),
+                         std::numeric_limits<double>::max_digits10,
+                         event.getTime(),
+                         mName.c_str(),
+                         event.getViewName().c_str(),
+                         event.getPortName().c_str());
+}
+
 void
 DynamicsDbg::finish()
 {
@@ -149,6 +149,14 @@ public:
     std::unique_ptr<vle::value::Value> observation(
       const ObservationEvent& event) const override;
 
+    /**
+     * @brief Process an observation event of a real or an integer.
+     * @param event the state event with of the port
+     * @param[out] value the observed real or integer
+     */
+    void scalarObservation(const ObservationEvent& event,
+                           ScalarObservation& value) const override;
+
     /**
      * @brief When the simulation of the atomic model is finished, the
      * finish method is invoked.
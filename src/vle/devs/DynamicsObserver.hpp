@@ -50,6 +50,11 @@ class DynamicsObserver : public Dynamics
     /// devs::Dynamics model.
     std::vector<Observation>& mObservations;
 
+    /// Append the observation of the \e port for the \e view at \e time.
+    /// The \e Dynamics::observation function is called only if the model
+    /// does not assign a scalar observation.
+    void observe(Time time, View* view, const std::string& port) const;
+
 public:
     // These vectors stores View and observation's port for earch function to
     // observer.
@@ -167,6 +172,14 @@ public:
     std::unique_ptr<vle::value::Value> observation(
       const ObservationEvent& event) const override;
 
+    /**
+     * Process an observation event of a real or an integer.
+     * @param event the state event with of the port
+     * @param[out] value the observed real or integer
+     */
+    void scalarObservation(const ObservationEvent& event,
+                           ScalarObservation& value) const override;
+
     /**
      * When the simulation of the atomic model is finished, the
      * finish method is invoked.
@@ -182,6 +195,21 @@ inline DynamicsObserver::DynamicsObserver(
   , mObservations(observations)
 {}
 
+inline void
+DynamicsObserver::observe(Time time, View* view, const std::string& port) const
+{
+    ObservationEvent event(time, view->name(), port);
+
+    mObservations.emplace_back();
+    auto& obs = mObservations.back();
+    obs.view = view;
+    obs.portname = port;
+
+    mDynamics->scalarObservation(event, obs.scalar);
+    if (not obs.scalar)
+        obs.value = mDynamics->observation(event);
+}
+
 inline bool
 DynamicsObserver::isExecutive() const
 {
@@ -220,13 +248,7 @@ DynamicsObserver::output(Time time, ExternalEventList& output) const
     mDynamics->output(time, output);
 
     for (const auto& elem : ppOutput) {
-        ObservationEvent event(
-          time, std::get<0>(elem)->name(), std::get<1>(elem));
-
-        mObservations.emplace_back();
-        mObservations.back().view = std::get<0>(elem);
-        mObservations.back().portname = std::get<1>(elem);
-        mObservations.back().value = mDynamics->observation(event);
+        observe(time, std::get<0>(elem), std::get<1>(elem));
     }
 }
 
@@ -246,13 +268,7 @@ DynamicsObserver::internalTransition(Time time)
     mDynamics->internalTransition(time);
 
     for (const auto& elem : ppInternal) {
-        ObservationEvent event(
-          time, std::get<0>(elem)->name(), std::get<1>(elem));
-
-        mObservations.emplace_back();
-        mObservations.back().view = std::get<0>(elem);
-        mObservations.back().portname = std::get<1>(elem);
-        mObservations.back().value = mDynamics->observation(event);
+        observe(time, std::get<0>(elem), std::get<1>(elem));
     }
 }
 
@@ -264,13 +280,7 @@ DynamicsObserver::externalTransition(const ExternalEventList& event, Time time)
     mDynamics->externalTransition(event, time);
 
     for (const auto& elem : ppExternal) {
-        ObservationEvent event(
-          time, std::get<0>(elem)->name(), std::get<1>(elem));
-
-        mObservations.emplace_back();
-        mObservations.back().view = std::get<0>(elem);
-        mObservations.back().portname = std::get<1>(elem);
-        mObservations.back().value = mDynamics->observation(event);
+        observe(time, std::get<0>(elem), std::get<1>(elem));
     }
 }
 
@@ -281,13 +291,7 @@ DynamicsObserver::confluentTransitions(Time time,
     mDynamics->confluentTransitions(time, extEventlist);
 
     for (const auto& elem : ppConfluent) {
-        ObservationEvent event(
-          time, std::get<0>(elem)->name(), std::get<1>(elem));
-
-        mObservations.emplace_back();
-        mObservations.back().view = std::get<0>(elem);
-        mObservations.back().portname = std::get<1>(elem);
-        mObservations.back().value = mDynamics->observation(event);
+        observe(time, std::get<0>(elem), std::get<1>(elem));
     }
 }
 
@@ -299,6 +303,15 @@ DynamicsObserver::observation(const ObservationEvent& event) const
     return mDynamics->observation(event);
 }
 
+inline void
+DynamicsObserver::scalarObservation(const ObservationEvent& event,
+                                    ScalarObservation& value) const
+{
+    assert(mDynamics && "DynamicsObserver: missing set(Dynamics)");
+
+    mDynamics->scalarObservation(event, value);
+}
+
 inline void
 DynamicsObserver::finish()
 {
@@ -307,13 +320,7 @@ DynamicsObserver::finish()
     mDynamics->finish();
 
     for (const auto& elem : ppFinish) {
-        ObservationEvent event(
-          devs::infinity, std::get<0>(elem)->name(), std::get<1>(elem));
-
-        mObservations.emplace_back();
-        mObservations.back().view = std::get<0>(elem);
-        mObservations.back().portname = std::get<1>(elem);
-        mObservations.back().value = mDynamics->observation(event);
+        observe(devs::infinity, std::get<0>(elem), std::get<1>(elem));
     }
 }
 }
@@ -0,0 +1,659 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "devs/EventQueue.hpp"
+#include "devs/Simulator.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <cassert>
+#include <cmath>
+
+namespace vle {
+namespace devs {
+
+/**
+ * @brief A 4-ary min-heap of dates stored into a contiguous array. Each
+ * date owns a bucket of all the simulators scheduled at this date and a
+ * hash map gives the bucket of a date. Consequently, the simulators of a
+ * bag are extracted in one operation with \e pop_all.
+ *
+ * The handle of a \e Simulator is a slot into \e m_slots which stores its
+ * bucket and its position into the bucket.
+ */
+class HeapEventQueue : public EventQueue
+{
+    struct Slot
+    {
+        Simulator* simulator;
+        HandleT bucket;
+        HandleT position;
+    };
+
+    struct Bucket
+    {
+        Time time;
+        HandleT heap;
+        std::vector<HandleT> slots;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<HandleT> m_free_slots;
+    std::vector<Bucket> m_buckets;
+    std::vector<HandleT> m_free_buckets;
+    std::unordered_map<Time, HandleT> m_dates;
+    std::vector<HandleT> m_heap;
+    std::size_t m_size;
+
+    Time date(std::size_t i) const noexcept
+    {
+        return m_buckets[m_heap[i]].time;
+    }
+
+    void place(std::size_t i, HandleT bucket) noexcept
+    {
+        m_heap[i] = bucket;
+        m_buckets[bucket].heap = static_cast<HandleT>(i);
+    }
+
+    void up(std::size_t i) noexcept
+    {
+        const HandleT bucket = m_heap[i];
+        const Time time = m_buckets[bucket].time;
+
+        while (i > 0) {
+            auto parent = (i - 1) / 4;
+            if (date(parent) <= time)
+                break;
+
+            place(i, m_heap[parent]);
+            i = parent;
+        }
+
+        place(i, bucket);
+    }
+
+    void down(std::size_t i) noexcept
+    {
+        const HandleT bucket = m_heap[i];
+        const Time time = m_buckets[bucket].time;
+        const auto size = m_heap.size();
+
+        for (;;) {
+            auto child = 4 * i + 1;
+            if (child >= size)
+                break;
+
+            auto last = std::min(child + 4, size);
+            auto min = child;
+            for (++child; child < last; ++child)
+                if (date(child) < date(min))
+                    min = child;
+
+            if (time <= date(min))
+                break;
+
+            place(i, m_heap[min]);
+            i = min;
+        }
+
+        place(i, bucket);
+    }
+
+    HandleT get_bucket(Time time)
+    {
+        auto it = m_dates.find(time);
+        if (it != m_dates.end())
+            return it->second;
+
+        HandleT bucket;
+        if (m_free_buckets.empty()) {
+            bucket = static_cast<HandleT>(m_buckets.size());
+            m_buckets.emplace_back();
+        } else {
+            bucket = m_free_buckets.back();
+            m_free_buckets.pop_back();
+        }
+
+        m_buckets[bucket].time = time;
+        m_dates.emplace(time, bucket);
+
+        m_heap.push_back(bucket);
+        up(m_heap.size() - 1);
+
+        return bucket;
+    }
+
+    void release_bucket(HandleT bucket) noexcept
+    {
+        const Time time = m_buckets[bucket].time;
+        const std::size_t i = m_buckets[bucket].heap;
+
+        m_dates.erase(time);
+        m_free_buckets.push_back(bucket);
+
+        HandleT last = m_heap.back();
+        m_heap.pop_back();
+
+        if (i < m_heap.size()) {
+            place(i, last);
+            if (m_buckets[last].time < time)
+                up(i);
+            else
+                down(i);
+        }
+    }
+
+    HandleT get_slot(Simulator* simulator)
+    {
+        HandleT slot;
+
+        if (m_free_slots.empty()) {
+            slot = static_cast<HandleT>(m_slots.size());
+            m_slots.push_back({ simulator, 0, 0 });
+        } else {
+            slot = m_free_slots.back();
+            m_free_slots.pop_back();
+            m_slots[slot].simulator = simulator;
+        }
+
+        simulator->setHandle(slot);
+        ++m_size;
+
+        return slot;
+    }
+
+    void release_slot(HandleT slot) noexcept
+    {
+        m_slots[slot].simulator->resetHandle();
+        m_slots[slot].simulator = nullptr;
+        m_free_slots.push_back(slot);
+        --m_size;
+    }
+
+    void attach(HandleT slot, Time time)
+    {
+        auto bucket = get_bucket(time);
+        auto& slots = m_buckets[bucket].slots;
+
+        m_slots[slot].bucket = bucket;
+        m_slots[slot].position = static_cast<HandleT>(slots.size());
+        slots.push_back(slot);
+    }
+
+    void detach(HandleT slot) noexcept
+    {
+        const auto bucket = m_slots[slot].bucket;
+        const auto position = m_slots[slot].position;
+        auto& slots = m_buckets[bucket].slots;
+
+        slots[position] = slots.back();
+        m_slots[slots[position]].position = position;
+        slots.pop_back();
+
+        if (slots.empty())
+            release_bucket(bucket);
+    }
+
+public:
+    HeapEventQueue()
+      : m_size(0)
+    {}
+
+    bool empty() const noexcept override
+    {
+        return m_size == 0;
+    }
+
+    Time top() noexcept override
+    {
+        return m_heap.empty() ? infinity : date(0);
+    }
+
+    void push(Simulator* simulator, Time time) override
+    {
+        if (simulator->haveHandle()) {
+            auto slot = simulator->handle();
+            if (m_buckets[m_slots[slot].bucket].time == time)
+                return;
+
+            detach(slot);
+            attach(slot, time);
+        } else {
+            attach(get_slot(simulator), time);
+        }
+    }
+
+    void erase(Simulator* simulator) noexcept override
+    {
+        if (not simulator->haveHandle())
+            return;
+
+        auto slot = simulator->handle();
+        detach(slot);
+        release_slot(slot);
+    }
+
+    Simulator* pop() noexcept override
+    {
+        if (m_heap.empty())
+            return nullptr;
+
+        auto slot = m_buckets[m_heap.front()].slots.back();
+        Simulator* ret = m_slots[slot].simulator;
+
+        detach(slot);
+        release_slot(slot);
+
+        return ret;
+    }
+
+    void pop_all(std::vector<Simulator*>& simulators) override
+    {
+        if (m_heap.empty())
+            return;
+
+        auto bucket = m_heap.front();
+        auto& slots = m_buckets[bucket].slots;
+
+        for (auto slot : slots) {
+            simulators.emplace_back(m_slots[slot].simulator);
+            release_slot(slot);
+        }
+
+        slots.clear();
+        release_bucket(bucket);
+    }
+};
+
+/**
+ * @brief A calendar queue (R. Brown, 1988). Events are hashed by date into
+ * an array of buckets of width \e m_width: a bucket stores all the events
+ * of the days \e d, \e d + nb, \e d + 2nb, etc. DEVS models produce a lot
+ * of events at the same date, they share a bucket and the earliest group
+ * of events is moved to the back of its bucket so that successive pops
+ * are O(1).
+ *
+ * The handle of a \e Simulator is a slot into \e m_slots. Rescheduling or
+ * erasing a \e Simulator increments the generation of its slot: old
+ * entries become stale and are removed lazily.
+ */
+class CalendarEventQueue : public EventQueue
+{
+    struct Slot
+    {
+        Simulator* simulator;
+        Time time;
+        std::uint32_t generation;
+    };
+
+    struct Entry
+    {
+        Time time;
+        std::int64_t day;
+        HandleT slot;
+        std::uint32_t generation;
+    };
+
+    std::vector<std::vector<Entry>> m_buckets;
+    std::vector<Slot> m_slots;
+    std::vector<HandleT> m_free_slots;
+    double m_width;
+    std::size_t m_size;
+    std::size_t m_stale;
+    Time m_last;
+
+    //
+    // The earliest group of events (all entries of the same date \e
+    // m_group_time) is stored at the back of the bucket \e m_group_bucket.
+    //
+    bool m_group;
+    std::size_t m_group_bucket;
+    std::size_t m_group_size;
+    Time m_group_time;
+
+    static constexpr std::size_t min_buckets = 64;
+
+    std::int64_t day(Time time) const noexcept
+    {
+        const double max = 9.0e18;
+        double d = std::floor(time / m_width);
+
+        return static_cast<std::int64_t>(std::max(-max, std::min(max, d)));
+    }
+
+    std::size_t bucket(std::int64_t day) const noexcept
+    {
+        return static_cast<std::size_t>(static_cast<std::uint64_t>(day) &
+                                        (m_buckets.size() - 1));
+    }
+
+    bool valid(const Entry& entry) const noexcept
+    {
+        return m_slots[entry.slot].generation == entry.generation;
+    }
+
+    /**
+     * Remove stale entries from the bucket \e b and returns the lowest
+     * date of the valid entries with a day lower or equal to \e limit.
+     */
+    Time clean(std::size_t b, std::int64_t limit) noexcept
+    {
+        auto& bucket = m_buckets[b];
+        Time ret = infinity;
+
+        for (std::size_t i = 0; i < bucket.size();) {
+            if (not valid(bucket[i])) {
+                bucket[i] = bucket.back();
+                bucket.pop_back();
+                --m_stale;
+            } else {
+                if (bucket[i].day <= limit and bucket[i].time < ret)
+                    ret = bucket[i].time;
+                ++i;
+            }
+        }
+
+        return ret;
+    }
+
+    void make_group(std::size_t b, Time time) noexcept
+    {
+        auto& bucket = m_buckets[b];
+        auto it =
+          std::partition(bucket.begin(), bucket.end(), [time](const Entry& e) {
+              return e.time != time;
+          });
+
+        m_group = true;
+        m_group_bucket = b;
+        m_group_size = static_cast<std::size_t>(bucket.end() - it);
+        m_group_time = time;
+    }
+
+    void locate() noexcept
+    {
+        if (m_group or m_size == 0)
+            return;
+
+        if (not isNegativeInfinity(m_last)) {
+            const auto first = day(m_last);
+            const auto nb = static_cast<std::int64_t>(m_buckets.size());
+
+            for (std::int64_t n = 0; n != nb; ++n) {
+                auto b = bucket(first + n);
+                auto time = clean(b, first + n);
+
+                if (not isInfinity(time)) {
+                    make_group(b, time);
+                    return;
+                }
+            }
+        }
+
+        //
+        // No event in the current year, we search the earliest event into
+        // all buckets.
+        //
+
+        Time time = infinity;
+        std::size_t found = 0;
+        for (std::size_t b = 0, e = m_buckets.size(); b != e; ++b) {
+            auto t = clean(b, std::numeric_limits<std::int64_t>::max());
+            if (t < time) {
+                time = t;
+                found = b;
+            }
+        }
+
+        assert(not isInfinity(time) && "CalendarEventQueue: bad size");
+        m_last = time;
+        make_group(found, time);
+    }
+
+    void insert(const Entry& entry)
+    {
+        auto b = bucket(entry.day);
+        auto& bucket = m_buckets[b];
+
+        bucket.push_back(entry);
+
+        if (not m_group)
+            return;
+
+        if (entry.time < m_group_time) {
+            m_group = false;
+        } else if (b == m_group_bucket) {
+            if (entry.time == m_group_time)
+                ++m_group_size;
+            else
+                std::swap(bucket.back(),
+                          bucket[bucket.size() - 1 - m_group_size]);
+        }
+    }
+
+    /**
+     * Rebuild the calendar with \e nb buckets. The width of the buckets is
+     * computed from the mean gap between the first distinct dates.
+     */
+    void rebuild(std::size_t nb, bool compute_width)
+    {
+        std::vector<Entry> entries;
+        entries.reserve(m_size);
+
+        for (auto& bucket : m_buckets)
+            for (auto& entry : bucket)
+                if (valid(entry))
+                    entries.push_back(entry);
+
+        if (compute_width and entries.size() > 1) {
+            std::vector<Time> times(entries.size());
+            std::transform(entries.begin(),
+                           entries.end(),
+                           times.begin(),
+                           [](const Entry& e) { return e.time; });
+
+            std::sort(times.begin(), times.end());
+            times.erase(std::unique(times.begin(), times.end()), times.end());
+
+            const std::size_t samples = std::min(times.size(), std::size_t{
+                                                                 65 });
+            if (samples > 1) {
+                double gap = (times[samples - 1] - times[0]) / (samples - 1);
+                if (gap > 0.0 and std::isfinite(gap))
+                    m_width = 3.0 * gap;
+            }
+        }
+
+        m_buckets.clear();
+        m_buckets.resize(nb);
+        m_stale = 0;
+        m_group = false;
+
+        for (auto& entry : entries) {
+            entry.day = day(entry.time);
+            m_buckets[bucket(entry.day)].push_back(entry);
+        }
+    }
+
+    void release(HandleT slot) noexcept
+    {
+        m_slots[slot].simulator->resetHandle();
+        m_slots[slot].simulator = nullptr;
+        m_slots[slot].generation++;
+        m_free_slots.push_back(slot);
+        --m_size;
+    }
+
+public:
+    CalendarEventQueue()
+      : m_buckets(min_buckets)
+      , m_width(1.0)
+      , m_size(0)
+      , m_stale(0)
+      , m_last(negativeInfinity)
+      , m_group(false)
+      , m_group_bucket(0)
+      , m_group_size(0)
+      , m_group_time(infinity)
+    {}
+
+    bool empty() const noexcept override
+    {
+        return m_size == 0;
+    }
+
+    Time top() noexcept override
+    {
+        locate();
+
+        return m_size == 0 ? infinity : m_group_time;
+    }
+
+    void push(Simulator* simulator, Time time) override
+    {
+        HandleT slot;
+
+        if (simulator->haveHandle()) {
+            slot = simulator->handle();
+            if (m_group and m_slots[slot].time == m_group_time)
+                m_group = false;
+
+            m_slots[slot].generation++;
+            m_stale++;
+        } else {
+            if (m_free_slots.empty()) {
+                slot = static_cast<HandleT>(m_slots.size());
+                m_slots.push_back({ nullptr, time, 0 });
+            } else {
+                slot = m_free_slots.back();
+                m_free_slots.pop_back();
+            }
+
+            m_slots[slot].simulator = simulator;
+            simulator->setHandle(slot);
+            m_size++;
+        }
+
+        m_slots[slot].time = time;
+
+        if (time < m_last)
+            m_last = time;
+
+        insert({ time, day(time), slot, m_slots[slot].generation });
+
+        if (m_size > 2 * m_buckets.size())
+            rebuild(2 * m_buckets.size(), true);
+        else if (m_stale > 2 * (m_size + m_buckets.size()))
+            rebuild(m_buckets.size(), false);
+    }
+
+    void erase(Simulator* simulator) noexcept override
+    {
+        if (not simulator->haveHandle())
+            return;
+
+        HandleT slot = simulator->handle();
+        if (m_group and m_slots[slot].time == m_group_time)
+            m_group = false;
+
+        release(slot);
+        m_stale++;
+    }
+
+    Simulator* pop() noexcept override
+    {
+        for (;;) {
+            locate();
+
+            if (m_size == 0)
+                return nullptr;
+
+            auto& bucket = m_buckets[m_group_bucket];
+            while (m_group_size > 0) {
+                Entry entry = bucket.back();
+                bucket.pop_back();
+                --m_group_size;
+
+                if (valid(entry)) {
+                    Simulator* ret = m_slots[entry.slot].simulator;
+                    release(entry.slot);
+                    m_last = entry.time;
+
+                    if (m_group_size == 0)
+                        m_group = false;
+
+                    return ret;
+                }
+
+                --m_stale;
+            }
+
+            m_group = false;
+        }
+    }
+
+    void pop_all(std::vector<Simulator*>& simulators) override
+    {
+        locate();
+
+        if (m_size == 0)
+            return;
+
+        auto& bucket = m_buckets[m_group_bucket];
+        const auto first = bucket.size() - m_group_size;
+
+        for (auto i = first, e = bucket.size(); i != e; ++i) {
+            if (valid(bucket[i])) {
+                simulators.emplace_back(m_slots[bucket[i].slot].simulator);
+                release(bucket[i].slot);
+            } else {
+                --m_stale;
+            }
+        }
+
+        bucket.resize(first);
+        m_last = m_group_time;
+        m_group = false;
+    }
+};
+
+std::unique_ptr<EventQueue>
+make_event_queue(const std::string& name)
+{
+    if (name == "heap")
+        return std::make_unique<HeapEventQueue>();
+
+    if (name == "calendar")
+        return std::make_unique<CalendarEventQueue>();
+
+    return nullptr;
+}
+}
+} // namespace vle devs
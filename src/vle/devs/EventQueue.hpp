@@ -0,0 +1,113 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_DEVS_EVENTQUEUE_HPP
+#define VLE_DEVS_EVENTQUEUE_HPP
+
+#include <vle/devs/Time.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+namespace vle {
+namespace devs {
+
+class Simulator;
+
+/**
+ * Index handle stored into each \e Simulator by the \e EventQueue. Its
+ * meaning depends on the implementation (generally a slot into a table of
+ * the queue) and must not be used outside.
+ */
+using HandleT = std::uint32_t;
+
+/**
+ * @brief EventQueue is the priority queue of internal events (one per \e
+ * Simulator) used by the \e Scheduler. Each \e Simulator appears at most
+ * once into the queue and keeps its index handle via the \e
+ * Simulator::setHandle/resetHandle functions.
+ *
+ * The implementation is selected at runtime with the \e
+ * vle.simulation.scheduler setting (see \e make_event_queue).
+ */
+class EventQueue
+{
+public:
+    virtual ~EventQueue() = default;
+
+    /**
+     * @return true if no event is scheduled.
+     */
+    virtual bool empty() const noexcept = 0;
+
+    /**
+     * @return the date of the earliest event or \e infinity if the queue
+     * is empty.
+     */
+    virtual Time top() noexcept = 0;
+
+    /**
+     * Schedule the \e simulator at date \e time. If the \e simulator is
+     * already scheduled, its date is updated.
+     */
+    virtual void push(Simulator* simulator, Time time) = 0;
+
+    /**
+     * Remove the \e simulator from the queue if it is scheduled.
+     */
+    virtual void erase(Simulator* simulator) noexcept = 0;
+
+    /**
+     * Remove the earliest event from the queue.
+     *
+     * @return the \e Simulator of the removed event or \e nullptr if the
+     * queue is empty.
+     */
+    virtual Simulator* pop() noexcept = 0;
+
+    /**
+     * Remove all the events scheduled at the earliest date from the queue
+     * and append their \e Simulator to the \e simulators vector.
+     */
+    virtual void pop_all(std::vector<Simulator*>& simulators) = 0;
+};
+
+/**
+ * Build the \e EventQueue implementation named \e name: \e heap (an array
+ * based 4-ary heap of dates, each date owns the bucket of the simulators
+ * scheduled at this date) or \e calendar (a calendar queue).
+ *
+ * @return a \e EventQueue or \e nullptr if \e name is unknown.
+ */
+std::unique_ptr<EventQueue>
+make_event_queue(const std::string& name);
+}
+} // namespace vle devs
+
+#endif
@@ -43,6 +43,53 @@
 namespace vle {
 namespace devs {
 
+void
+ExternalEvent::box() const
+{
+    switch (m_type) {
+    case scalar_type::boolean:
+        m_attributes = std::make_shared<value::Boolean>(m_scalar.boolean);
+        break;
+    case scalar_type::integer:
+        m_attributes = std::make_shared<value::Integer>(m_scalar.integer);
+        break;
+    case scalar_type::real:
+        m_attributes = std::make_shared<value::Double>(m_scalar.real);
+        break;
+    case scalar_type::none:
+        break;
+    }
+
+    m_type = scalar_type::none;
+}
+
+bool
+ExternalEvent::getBooleanValue() const
+{
+    if (m_type == scalar_type::boolean)
+        return m_scalar.boolean;
+
+    return getBoolean().value();
+}
+
+std::int32_t
+ExternalEvent::getIntegerValue() const
+{
+    if (m_type == scalar_type::integer)
+        return m_scalar.integer;
+
+    return getInteger().value();
+}
+
+double
+ExternalEvent::getDoubleValue() const
+{
+    if (m_type == scalar_type::real)
+        return m_scalar.real;
+
+    return getDouble().value();
+}
+
 value::Boolean&
 ExternalEvent::addBoolean(bool value)
 {
@@ -112,6 +159,9 @@ ExternalEvent::addMatrix(std::size_t columns,
 const value::Boolean&
 ExternalEvent::getBoolean() const
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isBoolean())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Boolean."));
@@ -122,6 +172,9 @@ ExternalEvent::getBoolean() const
 value::Boolean&
 ExternalEvent::getBoolean()
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isBoolean())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Boolean."));
@@ -132,6 +185,9 @@ ExternalEvent::getBoolean()
 const value::Double&
 ExternalEvent::getDouble() const
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isDouble())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Double."));
@@ -142,6 +198,9 @@ ExternalEvent::getDouble() const
 value::Double&
 ExternalEvent::getDouble()
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isDouble())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Double."));
@@ -152,6 +211,9 @@ ExternalEvent::getDouble()
 const value::Integer&
 ExternalEvent::getInteger() const
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isInteger())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Integer."));
@@ -162,6 +224,9 @@ ExternalEvent::getInteger() const
 value::Integer&
 ExternalEvent::getInteger()
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isInteger())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Integer."));
@@ -172,6 +237,9 @@ ExternalEvent::getInteger()
 const value::String&
 ExternalEvent::getString() const
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isString())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a String."));
@@ -182,6 +250,9 @@ ExternalEvent::getString() const
 value::String&
 ExternalEvent::getString()
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isString())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a String."));
@@ -192,6 +263,9 @@ ExternalEvent::getString()
 const value::Xml&
 ExternalEvent::getXml() const
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isXml())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Xml."));
@@ -202,6 +276,9 @@ ExternalEvent::getXml() const
 value::Xml&
 ExternalEvent::getXml()
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isXml())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Xml."));
@@ -212,6 +289,9 @@ ExternalEvent::getXml()
 const value::Tuple&
 ExternalEvent::getTuple() const
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isTuple())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Tuple."));
@@ -222,6 +302,9 @@ ExternalEvent::getTuple() const
 value::Tuple&
 ExternalEvent::getTuple()
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isTuple())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Tuple."));
@@ -232,6 +315,9 @@ ExternalEvent::getTuple()
 const value::Table&
 ExternalEvent::getTable() const
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isTable())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Table."));
@@ -242,6 +328,9 @@ ExternalEvent::getTable() const
 value::Table&
 ExternalEvent::getTable()
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isTable())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Table."));
@@ -252,6 +341,9 @@ ExternalEvent::getTable()
 const value::Map&
 ExternalEvent::getMap() const
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isMap())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Map."));
@@ -262,6 +354,9 @@ ExternalEvent::getMap() const
 value::Map&
 ExternalEvent::getMap()
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isMap())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Map."));
@@ -272,6 +367,9 @@ ExternalEvent::getMap()
 const value::Set&
 ExternalEvent::getSet() const
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isSet())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Set."));
@@ -282,6 +380,9 @@ ExternalEvent::getSet() const
 value::Set&
 ExternalEvent::getSet()
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isSet())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Set."));
@@ -292,6 +393,9 @@ ExternalEvent::getSet()
 const value::Matrix&
 ExternalEvent::getMatrix() const
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isMatrix())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Matrix."));
@@ -302,6 +406,9 @@ ExternalEvent::getMatrix() const
 value::Matrix&
 ExternalEvent::getMatrix()
 {
+    if (m_type != scalar_type::none)
+        box();
+
     if (not m_attributes or not m_attributes->isMatrix())
         throw utils::ArgError(_("ExternalEvent: getAttributes is empty or"
                                 " is not a Matrix."));
@@ -47,16 +47,44 @@
 namespace vle {
 namespace devs {
 
+const ModelSymbols::Symbol&
+ModelSymbols::get(const utils::ContextPtr& context, const vpz::Dynamic& dyn)
+{
+    std::string key(dyn.package());
+    key += '/';
+    key += dyn.library();
+
+    auto it = m_symbols.find(key);
+    if (it != m_symbols.end())
+        return it->second;
+
+    Symbol symbol{ utils::Context::ModuleType::MODULE_DYNAMICS, nullptr, {} };
+
+    if (dyn.package().empty())
+        symbol.factory = get_factory(context, dyn.library());
+    else
+        symbol.symbol = get_symbol(context,
+                                   dyn.package(),
+                                   dyn.library(),
+                                   utils::Context::ModuleType::MODULE_DYNAMICS,
+                                   &symbol.type);
+
+    return m_symbols.emplace(std::move(key), std::move(symbol)).first->second;
+}
+
 ModelFactory::ModelFactory(utils::ContextPtr context,
                            std::map<std::string, View>& eventviews,
                            const vpz::Dynamics& dyn,
                            const vpz::Classes& cls,
-                           const vpz::Experiment& exp)
+                           const vpz::Experiment& exp,
+                           std::shared_ptr<ModelSymbols> symbols)
   : mContext(std::move(context))
   , mEventViews(eventviews)
   , mDynamics(dyn)
   , mClasses(cls)
   , mExperiment(exp)
+  , mSymbols(symbols ? std::move(symbols)
+                     : std::make_shared<ModelSymbols>())
 {}
 
 void
@@ -395,43 +423,39 @@ ModelFactory::attachDynamics(Coordinator& coordinator,
     // to build executable with dynamics.
 
     try {
-        if (!dyn.package().empty()) {
-            auto type = utils::Context::ModuleType::MODULE_DYNAMICS;
-            void* symbol =
-              get_symbol(mContext,
-                         dyn.package(),
-                         dyn.library(),
-                         utils::Context::ModuleType::MODULE_DYNAMICS,
-                         &type);
-
-            switch (type) {
+        const auto& sym = mSymbols->get(mContext, dyn);
+
+        if (sym.symbol) {
+            switch (sym.type) {
             case utils::Context::ModuleType::MODULE_DYNAMICS:
                 using fctdyn =
                   vle::devs::Dynamics* (*)(const vle::devs::DynamicsInit&,
                                            const vle::devs::InitEventList&);
 
-                return buildNewDynamics(mContext,
-                                        mEventViews,
-                                        mExperiment.views(),
-                                        observable,
-                                        atom,
-                                        dyn,
-                                        events,
-                                        utils::functionCast<fctdyn>(symbol));
+                return buildNewDynamics(
+                  mContext,
+                  mEventViews,
+                  mExperiment.views(),
+                  observable,
+                  atom,
+                  dyn,
+                  events,
+                  utils::functionCast<fctdyn>(sym.symbol));
             case utils::Context::ModuleType::MODULE_DYNAMICS_EXECUTIVE:
                 using fctexe =
                   vle::devs::Dynamics* (*)(const vle::devs::ExecutiveInit&,
                                            const vle::devs::InitEventList&);
 
-                return buildNewExecutive(mContext,
-                                         mEventViews,
-                                         mExperiment.views(),
-                                         observable,
-                                         coordinator,
-                                         atom,
-                                         dyn,
-                                         events,
-                                         utils::functionCast<fctexe>(symbol));
+                return buildNewExecutive(
+                  mContext,
+                  mEventViews,
+                  mExperiment.views(),
+                  observable,
+                  coordinator,
+                  atom,
+                  dyn,
+                  events,
+                  utils::functionCast<fctexe>(sym.symbol));
             case utils::Context::ModuleType::MODULE_DYNAMICS_WRAPPER:
                 using fctdw = vle::devs::
                   Dynamics* (*)(const vle::devs::DynamicsWrapperInit&,
@@ -442,12 +466,12 @@ ModelFactory::attachDynamics(Coordinator& coordinator,
                   atom,
                   dyn,
                   events,
-                  utils::functionCast<fctdw>(symbol));
+                  utils::functionCast<fctdw>(sym.symbol));
             default:
                 throw utils::InternalError("Missing type");
             }
         } else {
-            auto& fn = get_factory(mContext, dyn.library());
+            const auto& fn = sym.factory;
 
             if (fn.which() == 1)
                 return buildNewDynamics(
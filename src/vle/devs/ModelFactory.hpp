@@ -38,6 +38,10 @@
 #include <vle/vpz/Model.hpp>
 
 #include "devs/View.hpp"
+#include "utils/ContextPrivate.hpp"
+
+#include <memory>
+#include <unordered_map>
 
 namespace vle {
 namespace devs {
@@ -46,6 +50,39 @@ class Coordinator;
 class Simulator;
 class Dynamics;
 
+/**
+ * @brief Cache of the dynamics resolved by the ModelFactory: the symbol of
+ * the shared library or the factory of the utils::Context. A ModelSymbols
+ * can be kept between several simulations of the same model to resolve
+ * each dynamics only once. It is not thread-safe.
+ */
+class ModelSymbols
+{
+public:
+    using factory_type = boost::variant<utils::oov_factory_fct,
+                                        utils::dynamics_factory_fct,
+                                        utils::executive_factory_fct>;
+
+    struct Symbol
+    {
+        utils::Context::ModuleType type;
+        void* symbol;         /**< Symbol of the shared library or nullptr
+                                 if the dynamics comes from a factory. */
+        factory_type factory; /**< Factory of the context. */
+    };
+
+    /**
+     * @brief Get the symbol of the dynamics \e dyn. The symbol is resolved
+     * and stored at the first call.
+     * @throw utils::InternalError if the symbol does not exist.
+     */
+    const Symbol& get(const utils::ContextPtr& context,
+                      const vpz::Dynamic& dyn);
+
+private:
+    std::unordered_map<std::string, Symbol> m_symbols;
+};
+
 /**
  * @brief Read simulations plugin from models directories and manage models
  * classes.
@@ -59,12 +96,14 @@ public:
      * @param sim the simulator attached to this ModelFactory.
      * @param dyn the root dynamics of vpz::Dynamics to load.
      * @param cls the vpz::classes to parse vpz::Dynamics to load.
+     * @param symbols the cache of the resolved dynamics.
      */
     ModelFactory(utils::ContextPtr context,
                  std::map<std::string, View>& eventviews,
                  const vpz::Dynamics& dyn,
                  const vpz::Classes& cls,
-                 const vpz::Experiment& experiment);
+                 const vpz::Experiment& experiment,
+                 std::shared_ptr<ModelSymbols> symbols);
 
     ModelFactory(const ModelFactory& other) = delete;
     ModelFactory& operator=(const ModelFactory& other) = delete;
@@ -239,6 +278,7 @@ private:
     vpz::Classes mClasses;       /**< List of available vpz::Classes. */
     vpz::Experiment mExperiment; /**< A reference to the
                                    vpz::Experiment. */
+    std::shared_ptr<ModelSymbols> mSymbols;
 
     /**
      * Try to open the plug-in and return the type of opened plugin
@@ -47,19 +47,27 @@ RootCoordinator::~RootCoordinator() = default;
 void
 RootCoordinator::load(vpz::Vpz& io)
 {
-    m_begin = io.project().experiment().begin();
-    m_end = m_begin + io.project().experiment().duration();
+    load(io.project(), io.project().model(), nullptr);
+}
+
+void
+RootCoordinator::load(const vpz::Project& project,
+                      vpz::Model& model,
+                      std::shared_ptr<ModelSymbols> symbols)
+{
+    m_begin = project.experiment().begin();
+    m_end = m_begin + project.experiment().duration();
     m_currentTime = m_begin;
 
     m_coordinator = std::make_unique<Coordinator>(m_context,
-                                                  io.project().dynamics(),
-                                                  io.project().classes(),
-                                                  io.project().experiment());
+                                                  project.dynamics(),
+                                                  project.classes(),
+                                                  project.experiment(),
+                                                  std::move(symbols));
 
-    m_coordinator->init(
-      io.project().model(), m_currentTime, m_end, io.project().instance());
+    m_coordinator->init(model, m_currentTime, m_end, project.instance());
 
-    m_root = io.project().model().graph();
+    m_root = model.graph();
 }
 
 void
@@ -101,5 +109,14 @@ RootCoordinator::outputs() const
     }
     return {};
 }
+
+SimulatorProcessStatistics
+RootCoordinator::statistics() const noexcept
+{
+    if (m_coordinator) {
+        return m_coordinator->statistics();
+    }
+    return {};
+}
 }
 } // namespace vle devs
@@ -79,6 +79,20 @@ public:
      */
     void load(vpz::Vpz& vp);
 
+    /**
+     * @brief initialise a new Coordinator with the graph of the \e model
+     * and the dynamics, classes and experiment of the \e project. The
+     * graph is moved from \e model, the \e project is only read.
+     * Dynamics are resolved with \e symbols to share them between
+     * several simulations.
+     * @param project the dynamics, classes and experiment.
+     * @param model the graph of models to simulate.
+     * @param symbols the cache of the resolved dynamics.
+     */
+    void load(const vpz::Project& project,
+              vpz::Model& model,
+              std::shared_ptr<ModelSymbols> symbols);
+
     /**
      * @brief Initialise RootCoordinator and his Coordinator: initiale time
      * is define, coordinator init function is call.
@@ -118,6 +132,14 @@ public:
      */
     std::unique_ptr<value::Map> outputs() const;
 
+    /**
+     * Return the statistics of the parallel computation of the bags.
+     *
+     * @return The statistics of the \c Coordinator or zero if the
+     * simulation is not loaded.
+     */
+    SimulatorProcessStatistics statistics() const noexcept;
+
     /**
      * @brief Return a reference to the random generator.
      * @return Return a reference to the random generator.
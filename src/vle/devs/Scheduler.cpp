@@ -24,8 +24,12 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <vle/utils/Exception.hpp>
+
 #include "devs/Scheduler.hpp"
 #include "devs/Simulator.hpp"
+#include "utils/ContextPrivate.hpp"
+#include "utils/i18n.hpp"
 
 #include <memory>
 #include <vector>
@@ -35,6 +39,20 @@
 namespace vle {
 namespace devs {
 
+Scheduler::Scheduler(utils::ContextPtr context)
+  : m_current_time(negativeInfinity)
+{
+    std::string name = "heap";
+    context->get_setting("vle.simulation.scheduler", &name);
+
+    m_scheduler = make_event_queue(name);
+    if (not m_scheduler)
+        throw utils::ArgError(_("Simulation kernel: unknown scheduler `%s'"),
+                              name.c_str());
+
+    context->info(_("Simulation kernel: scheduler:%s\n"), name.c_str());
+}
+
 void
 Scheduler::init(Time time)
 {
@@ -42,32 +60,11 @@ Scheduler::init(Time time)
 
     m_current_bag.dynamics.clear();
     m_current_bag.executives.clear();
-    m_current_bag.unique_simulators.clear();
-
-    while (not m_scheduler.empty() and
-           m_scheduler.top().m_time <= m_current_time) {
-
-        Simulator* sim = m_scheduler.top().m_simulator;
+    m_current_bag.epoch++;
 
-        //
-        // Add the simulator pointer into the unordered_set and into the
-        // vector. In std::unordered_set to be sure that only one pointer is
-        // available after the Coordinator::dispatchExternalEvents' call and in
-        // std::vector to starts directly without merge vectors with
-        // unordered_set.
-        //
-
-        if (sim->dynamics()->isExecutive())
-            m_current_bag.executives.emplace_back(sim);
-        else
-            m_current_bag.dynamics.emplace_back(sim);
-
-        m_current_bag.unique_simulators.emplace(sim);
-
-        sim->setInternalEvent();
-        sim->resetHandle();
-        m_scheduler.pop();
-    }
+    while (not m_scheduler->empty() and
+           m_scheduler->top() <= m_current_time)
+        popCurrentBag();
 }
 
 void
@@ -77,35 +74,30 @@ Scheduler::addInternal(Simulator* simulator, Time time)
     assert(not isNegativeInfinity(time) && "addInternal: infinity time?");
     assert(time >= m_current_time && "addInternal: time < m_current_time?");
 
-    if (simulator->haveHandle()) {
-        (*simulator->handle()).m_time = time;
-        m_scheduler.update(simulator->handle());
-    } else {
-        HandleT handle = m_scheduler.emplace(time, simulator);
-        simulator->setHandle(handle);
-    }
+    m_scheduler->push(simulator, time);
 }
 
 void
 Scheduler::addExternal(Simulator* simulator,
-                       std::shared_ptr<value::Value> values,
+                       const ExternalEvent& event,
                        const std::string& portname)
 {
     //
-    // Tries to insert the simulator into the std::unordered_set. If insertion
-    // success, (simulator does not exists with an internal transition), we add
-    // it into the appropriate std::vector.
+    // If the simulator does not belong to the current bag (simulator does
+    // not exists with an internal transition), we add it into the
+    // appropriate std::vector.
     //
 
-    auto result = m_current_bag.unique_simulators.emplace(simulator);
-    if (result.second == true) {
+    if (not simulator->inBag(m_current_bag.epoch)) {
+        simulator->setBag(m_current_bag.epoch);
+
         if (simulator->dynamics()->isExecutive())
             m_current_bag.executives.emplace_back(simulator);
         else
             m_current_bag.dynamics.emplace_back(simulator);
     }
 
-    simulator->addExternalEvents(values, portname);
+    simulator->addExternalEvent(event, portname);
 
     //
     // If an external event exists in the scheduler and not for the next
@@ -113,8 +105,7 @@ Scheduler::addExternal(Simulator* simulator,
     //
 
     if (simulator->haveHandle() and simulator->getTn() > m_current_time) {
-        m_scheduler.erase(simulator->handle());
-        simulator->resetHandle();
+        m_scheduler->erase(simulator);
         assert(not simulator->haveInternalEvent() && "Bad scheduler");
     }
 }
@@ -123,8 +114,7 @@ void
 Scheduler::delSimulator(Simulator* simulator)
 {
     //
-    // Tries to delete the simulator from the \c Bag objects (\c std::vector
-    // and/or \c std::unordered_set
+    // Tries to delete the simulator from the \c Bag objects (\c std::vector)
     //
 
     if (simulator->dynamics()->isExecutive())
@@ -140,47 +130,54 @@ Scheduler::delSimulator(Simulator* simulator)
                       simulator),
           m_current_bag.dynamics.end());
 
-    m_current_bag.unique_simulators.erase(simulator);
+    simulator->setBag(0);
 
-    if (simulator->haveHandle()) {
-        m_scheduler.erase(simulator->handle());
-        simulator->resetHandle();
-    }
+    m_scheduler->erase(simulator);
 }
 
 void
-Scheduler::makeNextBag()
+Scheduler::popCurrentBag()
 {
-    m_current_time = getNextTime();
+    auto& dynamics = m_current_bag.dynamics;
+    const auto first = dynamics.size();
 
-    m_current_bag.dynamics.clear();
-    m_current_bag.executives.clear();
-    m_current_bag.unique_simulators.clear();
+    m_scheduler->pop_all(dynamics);
 
-    while (not m_scheduler.empty() and
-           m_scheduler.top().m_time == m_current_time) {
+    //
+    // All the simulators of the earliest date are appended in one operation
+    // into the dynamics vector, then executives (rare) are moved into the
+    // executives vector. Simulators are also marked with the bag epoch to
+    // be sure that only one pointer is available after the
+    // Coordinator::dispatchExternalEvents' call.
+    //
 
-        Simulator* sim = m_scheduler.top().m_simulator;
+    auto last = first;
+    for (auto i = first, e = dynamics.size(); i != e; ++i) {
+        Simulator* sim = dynamics[i];
 
-        //
-        // Add the simulator pointer into the unordered_set and into the
-        // vector. In std::unordered_set to be sure that only one pointer is
-        // available after the Coordinator::dispatchExternalEvents' call and in
-        // std::vector to starts directly without merge vectors with
-        // unordered_set.
-        //
+        sim->setInternalEvent();
+        sim->setBag(m_current_bag.epoch);
 
         if (sim->dynamics()->isExecutive())
             m_current_bag.executives.emplace_back(sim);
         else
-            m_current_bag.dynamics.emplace_back(sim);
+            dynamics[last++] = sim;
+    }
 
-        m_current_bag.unique_simulators.emplace(sim);
+    dynamics.resize(last);
+}
 
-        sim->setInternalEvent();
-        sim->resetHandle();
-        m_scheduler.pop();
-    }
+void
+Scheduler::makeNextBag()
+{
+    m_current_time = getNextTime();
+
+    m_current_bag.dynamics.clear();
+    m_current_bag.executives.clear();
+    m_current_bag.epoch++;
+
+    if (not m_scheduler->empty())
+        popCurrentBag();
 }
 }
 } // namespace vle devs
@@ -30,14 +30,17 @@
 #include <vle/DllDefines.hpp>
 #include <vle/devs/ExternalEvent.hpp>
 
-#include "devs/ViewEvent.hpp"
+#include <vle/utils/Context.hpp>
 
-#include <boost/heap/fibonacci_heap.hpp>
+#include "devs/EventQueue.hpp"
+#include "devs/ViewEvent.hpp"
 
+#include <algorithm>
 #include <map>
-#include <unordered_set>
 #include <vector>
 
+#include <cstdint>
+
 namespace vle {
 namespace devs {
 
@@ -96,33 +99,6 @@ push(SchedulerT& scheduler, Args&&... args)
       scheduler.begin(), scheduler.end(), EventCompare<event_type>);
 }
 
-struct HeapElementCompare
-{
-    template<typename HeapElementT>
-    bool operator()(const HeapElementT& lhs, const HeapElementT& rhs) const
-      noexcept
-    {
-        return lhs.m_time >= rhs.m_time;
-    }
-};
-
-struct HeapElement
-{
-    HeapElement(Time time, Simulator* Simulator)
-      : m_time(time)
-      , m_simulator(Simulator)
-    {}
-
-    Time m_time;
-    Simulator* m_simulator;
-};
-
-using Heap =
-  boost::heap::fibonacci_heap<HeapElement,
-                              boost::heap::compare<HeapElementCompare>>;
-
-using HandleT = Heap::handle_type;
-
 /**
  * @brief Bag stores \e Simulator that need to be call in this bag.
  *
@@ -133,18 +109,23 @@ struct Bag
     std::vector<Simulator*> executives;
 
     //
-    // \e unique_simulators is used to ensures that \e dynamics and \e
-    // executives vectors have unique pointer through a \e simulator object.
+    // \e epoch identifies the current bag and is used to ensures that \e
+    // dynamics and \e executives vectors have unique pointer through a \e
+    // simulator object: a simulator belongs to the bag if its bag epoch
+    // equals \e epoch.
     //
-    std::unordered_set<Simulator*> unique_simulators;
+    std::uint64_t epoch = 1;
 };
 
 class Scheduler
 {
 public:
-    Scheduler()
-      : m_current_time(negativeInfinity)
-    {}
+    /**
+     * Build the scheduler. The implementation of the event queue is read
+     * from the \e vle.simulation.scheduler setting (\e heap or \e
+     * calendar).
+     */
+    Scheduler(utils::ContextPtr context);
 
     ~Scheduler() = default;
 
@@ -157,7 +138,7 @@ public:
 
     void addInternal(Simulator* simulator, Time time);
     void addExternal(Simulator* simulator,
-                     std::shared_ptr<value::Value> values,
+                     const ExternalEvent& event,
                      const std::string& portname);
     void delSimulator(Simulator* simulator);
 
@@ -171,19 +152,22 @@ public:
         return m_current_time;
     }
 
-    Time getNextTime() const noexcept
+    Time getNextTime() noexcept
     {
-        if (not m_scheduler.empty())
-            return m_scheduler.top().m_time;
-
-        return infinity;
+        return m_scheduler->top();
     }
 
     void makeNextBag();
 
 private:
+    /**
+     * Remove all the simulators of the earliest date from the event queue
+     * and append them to the current bag.
+     */
+    void popCurrentBag();
+
     Bag m_current_bag;
-    Heap m_scheduler;
+    std::unique_ptr<EventQueue> m_scheduler;
     Time m_current_time;
 };
 
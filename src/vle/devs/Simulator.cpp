@@ -38,8 +38,11 @@ namespace devs {
 Simulator::Simulator(vpz::AtomicModel* atomic)
   : m_atomicModel(atomic)
   , m_tn(negativeInfinity)
+  , m_bag(0)
+  , m_handle(0)
   , m_have_handle(false)
   , m_have_internal(false)
+  , m_dirty_routes(false)
 {
     assert(atomic && "Simulator: missing vpz::AtomicMOdel");
 
@@ -47,63 +50,48 @@ Simulator::Simulator(vpz::AtomicModel* atomic)
 }
 
 void
-Simulator::updateSimulatorTargets(const std::string& port)
+Simulator::updateRoutes(PortNames& names)
 {
     assert(m_atomicModel);
 
-    mTargets.erase(port);
+    m_output_ports.clear();
+    m_route_offsets.clear();
+    m_routes.clear();
 
-    vpz::ModelPortList result;
-    m_atomicModel->getAtomicModelsTarget(port, result);
+    for (const auto& elem : m_atomicModel->getOutputPortList()) {
+        vpz::ModelPortList result;
+        m_atomicModel->getAtomicModelsTarget(elem.first, result);
 
-    if (result.begin() == result.end()) {
-        mTargets.emplace(port, TargetSimulator(nullptr, std::string()));
-        return;
-    }
-
-    for (auto& elem : result)
-        mTargets.emplace(
-          port,
-          TargetSimulator(
-            static_cast<vpz::AtomicModel*>(elem.first)->get_simulator(),
-            elem.second));
-}
+        m_output_ports.emplace_back(elem.first);
+        m_route_offsets.emplace_back(
+          static_cast<std::uint32_t>(m_routes.size()));
 
-std::pair<Simulator::iterator, Simulator::iterator>
-Simulator::targets(const std::string& port)
-{
-    auto x = mTargets.equal_range(port);
-
-    // If the updateSimulatorTargets function was never call, we update
-    // the simulator targets and try to retrieve the newest simulator
-    // targets.
-    if (x.first == x.second) {
-        updateSimulatorTargets(port);
-        x = mTargets.equal_range(port);
+        for (auto& target : result)
+            m_routes.push_back(
+              { static_cast<vpz::AtomicModel*>(target.first)->get_simulator(),
+                names.intern(target.second) });
     }
 
-    if (x.first->second.first == nullptr)
-        return { mTargets.end(), mTargets.end() };
-
-    return x;
+    m_route_offsets.emplace_back(static_cast<std::uint32_t>(m_routes.size()));
+    m_dirty_routes = false;
 }
 
-void
-Simulator::removeTargetPort(const std::string& port)
+RouteSpan
+Simulator::routes(const std::string& port) const noexcept
 {
-    auto it = mTargets.find(port);
+    assert(not m_dirty_routes);
 
-    if (it != mTargets.end()) {
-        mTargets.erase(it);
-    }
-}
+    //
+    // Models have only a few output ports: a linear search is faster than
+    // a hash table.
+    //
 
-void
-Simulator::addTargetPort(const std::string& port)
-{
-    assert(mTargets.find(port) == mTargets.end());
+    for (std::size_t i = 0, e = m_output_ports.size(); i != e; ++i)
+        if (m_output_ports[i] == port)
+            return { m_routes.data() + m_route_offsets[i],
+                     m_routes.data() + m_route_offsets[i + 1] };
 
-    mTargets.insert(value_type(port, TargetSimulator(nullptr, std::string())));
+    return { nullptr, nullptr };
 }
 
 void
@@ -133,6 +121,16 @@ Simulator::output(Time time)
     assert(m_result.empty());
 
     m_dynamics->output(time, m_result);
+
+    //
+    // Resolves the destinations of the output events here: the output
+    // function can be called in parallel and the routing table is only
+    // read.
+    //
+
+    m_result_routes.reserve(m_result.size());
+    for (const auto& elem : m_result)
+        m_result_routes.emplace_back(routes(elem.getPortName()));
 }
 
 Time
@@ -38,10 +38,64 @@
 #include "devs/Scheduler.hpp"
 #include "devs/View.hpp"
 
+#include <deque>
+#include <unordered_map>
+
 namespace vle {
 namespace devs {
 
 class Dynamics;
+class Simulator;
+
+/**
+ * @brief Intern the names of the input ports of the models into integer
+ * identifiers. One table is shared by all the \e Simulator of a \e
+ * Coordinator. Names are never moved: the external events received by the
+ * models refer to them.
+ */
+class PortNames
+{
+public:
+    /**
+     * Get the identifier of the port \e name and add it if it does not
+     * exist.
+     */
+    std::uint32_t intern(const std::string& name)
+    {
+        auto it = m_ids.find(name);
+        if (it != m_ids.end())
+            return it->second;
+
+        auto id = static_cast<std::uint32_t>(m_names.size());
+        m_names.emplace_back(name);
+        m_ids.emplace(name, id);
+
+        return id;
+    }
+
+    const std::string& operator[](std::uint32_t id) const noexcept
+    {
+        assert(id < m_names.size());
+
+        return m_names[id];
+    }
+
+private:
+    std::deque<std::string> m_names;
+    std::unordered_map<std::string, std::uint32_t> m_ids;
+};
+
+/**
+ * @brief A destination of an output port: a simulator and the identifier
+ * of its input port into the \e PortNames table.
+ */
+struct Route
+{
+    Simulator* simulator;
+    std::uint32_t port;
+};
+
+using RouteSpan = std::pair<const Route*, const Route*>;
 
 /**
  * @brief Represent a couple devs::AtomicModel and devs::Dynamic class to
@@ -51,13 +105,6 @@ class Dynamics;
 class Simulator
 {
 public:
-    typedef std::pair<Simulator*, std::string> TargetSimulator;
-    typedef std::multimap<std::string, TargetSimulator> TargetSimulatorList;
-    using const_iterator = TargetSimulatorList::const_iterator;
-    using iterator = TargetSimulatorList::iterator;
-    using size_type = TargetSimulatorList::size_type;
-    using value_type = TargetSimulatorList::value_type;
-
     /**
      * @brief Build a new devs::Simulator with an empty devs::Dynamics, a
      * null last time but a vpz::AtomicModel node.
@@ -106,34 +153,37 @@ public:
     /*-*-*-*-*-*-*-*-*-*/
 
     /**
-     * Browse model's structure to find Simulator connected to the
-     * specified output port.
+     * Browse model's structure to find Simulator connected to each output
+     * port and build the routing table: for each output port, a contiguous
+     * span of \e Route.
      *
-     * \param port The output port used to build simulators' target list.
+     * \param names The table used to intern the input port names.
      */
-    void updateSimulatorTargets(const std::string& port);
+    void updateRoutes(PortNames& names);
 
     /**
-     * Get begin and end iterators to find Simulator connected to the
-     * specified output port.
+     * Get the destinations of the specified output port.
      *
-     * \param port The output port to get the simulators' target list.
+     * \param port The output port.
      *
-     * \return Two iterators.
+     * \return A span of \e Route, empty if the port does not exist or is
+     * not connected.
      */
-    std::pair<iterator, iterator> targets(const std::string& port);
+    RouteSpan routes(const std::string& port) const noexcept;
 
     /**
-     * @brief Add an empty target port.
-     * @param port Name of the port.
+     * The routing table must be rebuild (see \e updateRoutes) before the
+     * next \e output call.
      */
-    void removeTargetPort(const std::string& port);
+    inline bool haveDirtyRoutes() const noexcept
+    {
+        return m_dirty_routes;
+    }
 
-    /**
-     * @brief Remove a target port.
-     * @param port Name of the port to remove.
-     */
-    void addTargetPort(const std::string& port);
+    inline void setDirtyRoutes() noexcept
+    {
+        m_dirty_routes = true;
+    }
 
     /*-*-*-*-*-*-*-*-*-*/
 
@@ -152,9 +202,19 @@ public:
         return m_result;
     }
 
+    /**
+     * Get the destinations of each external event of the \e result() list
+     * computed by the \e output function.
+     */
+    inline const std::vector<RouteSpan>& result_routes() const noexcept
+    {
+        return m_result_routes;
+    }
+
     inline void clear_result() noexcept
     {
         m_result.clear();
+        m_result_routes.clear();
     }
 
     inline Time getTn() const noexcept
@@ -189,10 +249,15 @@ public:
         return not m_external_events.empty();
     }
 
-    inline void addExternalEvents(std::shared_ptr<value::Value> values,
-                                  const std::string& portname)
+    /**
+     * Add a copy of the \e event received on the input port \e portname.
+     * The \e portname must be a name interned into the \e PortNames
+     * table.
+     */
+    inline void addExternalEvent(const ExternalEvent& event,
+                                 const std::string& portname)
     {
-        m_external_events.emplace_back(values, portname);
+        m_external_events.emplace_back(event, portname);
     }
 
     inline void setInternalEvent() noexcept
@@ -210,6 +275,19 @@ public:
         m_have_internal = false;
     }
 
+    /**
+     * Check if the simulator belongs to the bag identified by \e epoch.
+     */
+    inline bool inBag(std::uint64_t epoch) const noexcept
+    {
+        return m_bag == epoch;
+    }
+
+    inline void setBag(std::uint64_t epoch) noexcept
+    {
+        m_bag = epoch;
+    }
+
     inline std::vector<Observation>& getObservations() noexcept
     {
         return m_observations;
@@ -218,15 +296,20 @@ public:
 private:
     std::unique_ptr<Dynamics> m_dynamics;
     vpz::AtomicModel* m_atomicModel;
-    TargetSimulatorList mTargets;
+    std::vector<std::string> m_output_ports;
+    std::vector<std::uint32_t> m_route_offsets;
+    std::vector<Route> m_routes;
     ExternalEventList m_external_events;
     ExternalEventList m_result;
+    std::vector<RouteSpan> m_result_routes;
     std::vector<Observation> m_observations;
     std::string m_parents;
     Time m_tn;
+    std::uint64_t m_bag;
     HandleT m_handle;
     bool m_have_handle;
     bool m_have_internal;
+    bool m_dirty_routes;
 };
 }
 } // namespace vle devs
@@ -33,9 +33,17 @@
 #include "utils/ContextPrivate.hpp"
 #include "utils/i18n.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
+
+#include <cstdint>
 
 namespace vle {
 namespace devs {
@@ -60,54 +68,350 @@ simulator_process(SimulatorT* simulator, Time time) noexcept
     return true;
 }
 
+/**
+ * @brief Statistics of the \e SimulatorProcessParallel thread pool.
+ */
+struct SimulatorProcessStatistics
+{
+    std::uint64_t jobs = 0;       ///< Number of parallel \e for_each calls.
+    std::uint64_t sequential = 0; ///< Number of sequential \e for_each calls.
+    std::uint64_t small = 0;      ///< Sequential calls for too small bags.
+    std::uint64_t blocks = 0;     ///< Number of blocks of simulators computed.
+    std::uint64_t steals = 0;     ///< Number of blocks stolen from others.
+    std::uint64_t parks = 0;      ///< Number of times a worker was parked.
+    double block_size = 0.0;      ///< Mean block size of parallel calls.
+    double idle = 0.0;            ///< Time spent by workers without work (s).
+};
+
+/**
+ * @brief Online estimation of the cost of a phase of the simulation (the
+ * output functions or the transitions of the bags) used by the \e
+ * SimulatorProcessParallel to choose between a sequential or a parallel
+ * computation of a bag.
+ *
+ * The cost of a bag of \e n simulators is modeled as \e n * \e cost when
+ * computed sequentially and as \e overhead + \e n * \e cost / \e p when
+ * computed by \e p participants. Both parameters are exponential moving
+ * averages of the measured durations. To follow the behaviour of the
+ * models, the choice which is not predicted is periodically tried.
+ */
+class SimulatorProcessEstimator
+{
+    double m_cost = 0.0;     // Mean cost of one simulator (ns).
+    double m_overhead = 0.0; // Mean synchronization cost of a job (ns).
+    unsigned m_decisions = 0;
+
+    enum : unsigned
+    {
+        probe_period = 64
+    };
+
+    static double average(double mean, double sample) noexcept
+    {
+        return mean == 0.0 ? sample : mean + (sample - mean) / 8.0;
+    }
+
+public:
+    /**
+     * @return true if the bag of \e size simulators should be computed by
+     * the \e participants.
+     */
+    bool parallel(std::size_t size, std::size_t participants) noexcept
+    {
+        // Without measure, the first bag is computed sequentially to
+        // estimate the cost of a simulator.
+        if (m_cost == 0.0)
+            return false;
+
+        const double sequential = m_cost * size;
+        const double parallel =
+          m_overhead + sequential / static_cast<double>(participants);
+        const bool ret = parallel < sequential;
+
+        if (++m_decisions == probe_period) {
+            m_decisions = 0;
+            return not ret;
+        }
+
+        return ret;
+    }
+
+    /**
+     * @return the mean cost of one simulator in nanoseconds or 0 if
+     * unknown.
+     */
+    double cost() const noexcept
+    {
+        return m_cost;
+    }
+
+    void update_sequential(std::size_t size, double duration) noexcept
+    {
+        m_cost = average(m_cost, duration / static_cast<double>(size));
+    }
+
+    void update_parallel(std::size_t size,
+                         std::size_t participants,
+                         double duration) noexcept
+    {
+        const double work =
+          m_cost * size / static_cast<double>(participants);
+
+        m_overhead = average(m_overhead, std::max(0.0, duration - work));
+    }
+};
+
+/**
+ * @brief A work-stealing thread pool to compute the transitions of the
+ * simulators of a bag.
+ *
+ * At each \e for_each call, the blocks of simulators are split between the
+ * caller thread and the workers. Each participant consumes its own range
+ * of blocks from the front and, when empty, steals blocks from the back of
+ * the range of the others. Between two calls, workers spin for an adaptive
+ * duration then are parked on a condition variable: idle workers do not
+ * consume CPU during the sequential phases of the simulation.
+ *
+ * Small bags or bags too cheap to amortize the synchronization (see \e
+ * SimulatorProcessEstimator) are computed sequentially by the caller
+ * thread. If the \e vle.simulation.block-size setting is not strictly
+ * positive, the block size is computed for each bag.
+ */
 class SimulatorProcessParallel
 {
+    static constexpr std::size_t cache_line_size = 64;
+
+    //
+    // The fields are surrounded by padding arrays: the participants of the
+    // array allocated by new[] never share a cache line, without relying
+    // on an over-aligned new.
+    //
+    struct Participant
+    {
+        char front[cache_line_size];
+
+        //
+        // Range of blocks [begin, end[ packed into a 64 bits integer
+        // (begin in the high bits). The owner pops from the begin and
+        // thieves steal from the end with compare-and-swap.
+        //
+        std::atomic<std::uint64_t> range{ 0 };
+
+        std::atomic<std::uint64_t> blocks{ 0 };
+        std::atomic<std::uint64_t> steals{ 0 };
+        std::atomic<std::uint64_t> parks{ 0 };
+        std::atomic<std::uint64_t> idle{ 0 }; // in nanoseconds
+
+        char back[cache_line_size - 5 * sizeof(std::atomic<std::uint64_t>)];
+    };
+
+    enum : unsigned
+    {
+        spin_min = 64,
+        spin_max = 1u << 16,
+        blocks_per_participant = 4, // Blocks to steal in the adaptive mode.
+        block_duration = 2000       // Minimal work of a block (ns).
+    };
+
     std::vector<std::thread> m_workers;
-    std::atomic<long int> m_block_id;
-    std::atomic<long int> m_block_count;
-    std::atomic<bool> m_running_flag;
+    std::unique_ptr<Participant[]> m_participants;
+    std::size_t m_participants_count;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::condition_variable m_done;
+    std::atomic<std::uint64_t> m_generation;
+    std::atomic<long> m_remaining;
+    std::size_t m_parked;
+    std::atomic<bool> m_stop;
+    std::uint64_t m_jobs_count;
+    std::uint64_t m_sequential_count;
+    std::uint64_t m_small_count;
+    std::uint64_t m_block_size_sum;
 
     std::vector<Simulator*>* m_jobs;
-    Time m_time;
+    void (*m_function)(void*, Simulator*);
+    void* m_function_data;
+    std::exception_ptr m_exception;
     long m_block_size;
+    long m_fixed_block_size;
+
+    static std::uint64_t pack(std::uint32_t begin, std::uint32_t end) noexcept
+    {
+        return (static_cast<std::uint64_t>(begin) << 32) | end;
+    }
+
+    static std::uint32_t begin(std::uint64_t range) noexcept
+    {
+        return static_cast<std::uint32_t>(range >> 32);
+    }
+
+    static std::uint32_t end(std::uint64_t range) noexcept
+    {
+        return static_cast<std::uint32_t>(range & 0xffffffff);
+    }
+
+    /**
+     * Pop a block from the front of the range of the participant \e id.
+     * @return the block or -1 if the range is empty.
+     */
+    long pop(std::size_t id) noexcept
+    {
+        auto& range = m_participants[id].range;
+        auto current = range.load(std::memory_order_acquire);
+
+        while (begin(current) < end(current)) {
+            if (range.compare_exchange_weak(
+                  current,
+                  pack(begin(current) + 1, end(current)),
+                  std::memory_order_acq_rel,
+                  std::memory_order_acquire))
+                return begin(current);
+        }
+
+        return -1;
+    }
+
+    /**
+     * Steal a block from the back of the range of another participant.
+     * @return the block or -1 if all ranges are empty.
+     */
+    long steal(std::size_t id) noexcept
+    {
+        for (std::size_t i = 1; i < m_participants_count; ++i) {
+            auto& range =
+              m_participants[(id + i) % m_participants_count].range;
+            auto current = range.load(std::memory_order_acquire);
+
+            while (begin(current) < end(current)) {
+                if (range.compare_exchange_weak(
+                      current,
+                      pack(begin(current), end(current) - 1),
+                      std::memory_order_acq_rel,
+                      std::memory_order_acquire)) {
+                    m_participants[id].steals.fetch_add(
+                      1, std::memory_order_relaxed);
+                    return end(current) - 1;
+                }
+            }
+        }
+
+        return -1;
+    }
 
-    void run()
+    void work(std::size_t id) noexcept
     {
-        while (m_running_flag.load(std::memory_order_relaxed)) {
-            auto block = m_block_id.fetch_sub(1, std::memory_order_relaxed);
+        for (;;) {
+            auto block = pop(id);
+            if (block < 0)
+                block = steal(id);
+            if (block < 0)
+                return;
+
+            std::size_t first = block * m_block_size;
+            std::size_t last = std::min(m_jobs->size(), first + m_block_size);
+
+            for (; first < last; ++first) {
+                try {
+                    m_function(m_function_data, (*m_jobs)[first]);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (not m_exception)
+                        m_exception = std::current_exception();
+                }
+            }
+
+            m_participants[id].blocks.fetch_add(1, std::memory_order_relaxed);
+
+            if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_done.notify_one();
+            }
+        }
+    }
 
-            if (block >= 0) {
-                std::size_t begin = block * m_block_size;
-                std::size_t begin_plus_b = begin + m_block_size;
-                std::size_t end = std::min(m_jobs->size(), begin_plus_b);
+    void run(std::size_t id)
+    {
+        std::uint64_t seen = 0;
+        unsigned spin = spin_min;
 
-                for (; begin < end; ++begin)
-                    simulator_process((*m_jobs)[begin], m_time);
+        for (;;) {
+            auto start = std::chrono::steady_clock::now();
+            bool found = false;
+
+            //
+            // Adaptive spinning: if a job arrives during the spin, the next
+            // spin is longer. Otherwise, the worker is parked and the next
+            // spin is shorter.
+            //
+
+            for (unsigned i = 0; i != spin; ++i) {
+                if (m_generation.load(std::memory_order_acquire) != seen or
+                    m_stop.load(std::memory_order_relaxed)) {
+                    found = true;
+                    break;
+                }
+
+                if ((i & 63) == 63)
+                    std::this_thread::yield();
+            }
 
-                m_block_count.fetch_sub(1, std::memory_order_relaxed);
+            if (found) {
+                spin = std::min(spin * 2, unsigned{ spin_max });
             } else {
-                //
-                // TODO: Maybe we can use a yield instead of this
-                // sleep_for function to reduce the overhead of the
-                // current thread.
-                //
-                std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+                spin = std::max(spin / 2, unsigned{ spin_min });
+
+                std::unique_lock<std::mutex> lock(m_mutex);
+                ++m_parked;
+                m_participants[id].parks.fetch_add(1,
+                                                   std::memory_order_relaxed);
+                m_wakeup.wait(lock, [this, seen]() {
+                    return m_generation.load(std::memory_order_relaxed) !=
+                             seen or
+                           m_stop.load(std::memory_order_relaxed);
+                });
+                --m_parked;
             }
+
+            auto idle = std::chrono::steady_clock::now() - start;
+            m_participants[id].idle.fetch_add(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(idle)
+                .count(),
+              std::memory_order_relaxed);
+
+            if (m_stop.load(std::memory_order_relaxed))
+                return;
+
+            seen = m_generation.load(std::memory_order_acquire);
+            work(id);
         }
     }
 
 public:
     SimulatorProcessParallel(utils::ContextPtr context)
-      : m_jobs(nullptr)
+      : m_participants_count(1)
+      , m_generation(0)
+      , m_remaining(0)
+      , m_parked(0)
+      , m_stop(false)
+      , m_jobs_count(0)
+      , m_sequential_count(0)
+      , m_small_count(0)
+      , m_block_size_sum(0)
+      , m_jobs(nullptr)
+      , m_function(nullptr)
+      , m_function_data(nullptr)
     {
-        long block_size = 8;
+        long block_size = 0;
         {
             context->get_setting("vle.simulation.block-size", &block_size);
 
             if (block_size <= 0)
-                m_block_size = 8;
+                m_fixed_block_size = 0;
             else
-                m_block_size = block_size;
+                m_fixed_block_size = block_size;
+
+            m_block_size = m_fixed_block_size;
         }
 
         long workers_count = 1;
@@ -118,31 +422,31 @@ public:
                 workers_count = 0l;
         }
 
-        context->info(_("Simulation kernel: thread:%ld block-size:%ld\n"),
-                      workers_count,
-                      m_block_size);
+        if (m_fixed_block_size > 0)
+            context->info(_("Simulation kernel: thread:%ld block-size:%ld\n"),
+                          workers_count,
+                          m_fixed_block_size);
+        else
+            context->info(_("Simulation kernel: thread:%ld block-size:auto\n"),
+                          workers_count);
 
-        m_block_id.store(-1, std::memory_order_relaxed);
-        m_block_count.store(-1, std::memory_order_relaxed);
-        m_running_flag.store(true, std::memory_order_relaxed);
+        m_participants_count = static_cast<std::size_t>(workers_count) + 1;
+        m_participants = std::make_unique<Participant[]>(m_participants_count);
 
         try {
             m_workers.reserve(workers_count);
             for (long i = 0; i != workers_count; ++i)
-                m_workers.emplace_back(&SimulatorProcessParallel::run, this);
+                m_workers.emplace_back(
+                  &SimulatorProcessParallel::run, this, i + 1);
         } catch (...) {
-            m_running_flag.store(false, std::memory_order_relaxed);
+            stop();
             throw;
         }
     }
 
     ~SimulatorProcessParallel() noexcept
     {
-        m_running_flag.store(false, std::memory_order_relaxed);
-
-        for (auto& thread : m_workers)
-            if (thread.joinable())
-                thread.join();
+        stop();
     }
 
     bool parallelize() const noexcept
@@ -150,40 +454,200 @@ public:
         return not m_workers.empty();
     }
 
-    bool for_each(std::vector<Simulator*>& simulators, Time time) noexcept
+    /**
+     * Compute the transitions of all the \e simulators at date \e time.
+     */
+    bool for_each(std::vector<Simulator*>& simulators,
+                  SimulatorProcessEstimator& estimator,
+                  Time time) noexcept
+    {
+        auto fn = [time](Simulator* simulator) {
+            simulator_process(simulator, time);
+        };
+
+        for_each(simulators, estimator, fn);
+
+        return true;
+    }
+
+    /**
+     * Call the function \e fn for each simulator of the \e simulators
+     * vector. The function is called in parallel if the \e estimator
+     * predicts a gain and must only modify the simulator passed as
+     * parameter.
+     *
+     * @throw the first exception thrown by \e fn.
+     */
+    template<typename Function>
+    void for_each(std::vector<Simulator*>& simulators,
+                  SimulatorProcessEstimator& estimator,
+                  Function fn)
     {
+        const auto size = simulators.size();
+
+        if (size < 2 * m_participants_count) {
+            ++m_small_count;
+            for (auto* simulator : simulators)
+                fn(simulator);
+            return;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        if (estimator.parallel(size, m_participants_count)) {
+            run_job(simulators,
+                    &invoke<Function>,
+                    &fn,
+                    block_size(size, estimator.cost()));
+
+            estimator.update_parallel(
+              size, m_participants_count, elapsed(start));
+
+            if (m_exception) {
+                auto exception = m_exception;
+                m_exception = nullptr;
+                std::rethrow_exception(exception);
+            }
+        } else {
+            ++m_sequential_count;
+            for (auto* simulator : simulators)
+                fn(simulator);
+
+            estimator.update_sequential(size, elapsed(start));
+        }
+    }
+
+    /**
+     * Compute the sum of the statistics of all the participants. This
+     * function must be called outside of \e for_each.
+     */
+    SimulatorProcessStatistics statistics() const noexcept
+    {
+        SimulatorProcessStatistics ret;
+        std::uint64_t idle = 0;
+
+        ret.jobs = m_jobs_count;
+        ret.sequential = m_sequential_count;
+        ret.small = m_small_count;
+
+        if (m_jobs_count)
+            ret.block_size = static_cast<double>(m_block_size_sum) /
+                             static_cast<double>(m_jobs_count);
+
+        for (std::size_t i = 0; i != m_participants_count; ++i) {
+            const auto& p = m_participants[i];
+            ret.blocks += p.blocks.load(std::memory_order_relaxed);
+            ret.steals += p.steals.load(std::memory_order_relaxed);
+            ret.parks += p.parks.load(std::memory_order_relaxed);
+            idle += p.idle.load(std::memory_order_relaxed);
+        }
+
+        ret.idle = static_cast<double>(idle) * 1e-9;
+
+        return ret;
+    }
+
+private:
+    template<typename Function>
+    static void invoke(void* data, Simulator* simulator)
+    {
+        (*static_cast<Function*>(data))(simulator);
+    }
+
+    static double elapsed(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(
+                 std::chrono::steady_clock::now() - start)
+          .count();
+    }
+
+    /**
+     * Compute the block size of a bag of \e size simulators: enough blocks
+     * to let participants steal work but large enough to amortize the
+     * synchronization of a block.
+     */
+    long block_size(std::size_t size, double cost) const noexcept
+    {
+        if (m_fixed_block_size > 0)
+            return m_fixed_block_size;
+
+        const auto participants = static_cast<long>(m_participants_count);
+        const auto n = static_cast<long>(size);
+        long ret = n / (participants * blocks_per_participant);
+
+        if (cost > 0.0)
+            ret = std::max(ret, static_cast<long>(block_duration / cost));
+
+        ret = std::min(ret, (n + participants - 1) / participants);
+
+        return std::max(1l, ret);
+    }
+
+    void run_job(std::vector<Simulator*>& simulators,
+                 void (*function)(void*, Simulator*),
+                 void* data,
+                 long block_size) noexcept
+    {
+        if (simulators.empty())
+            return;
+
         m_jobs = &simulators;
-        m_time = time;
+        m_function = function;
+        m_function_data = data;
+        m_block_size = block_size;
+        m_block_size_sum += static_cast<std::uint64_t>(block_size);
+        ++m_jobs_count;
 
         auto sz =
           static_cast<long>((simulators.size() / m_block_size) +
                             ((simulators.size() % m_block_size) ? 1 : 0));
 
-        m_block_count.store(sz, std::memory_order_relaxed);
-        m_block_id.store(sz, std::memory_order_relaxed);
+        m_remaining.store(sz, std::memory_order_relaxed);
 
-        for (;;) {
-            auto block = m_block_id.fetch_sub(1, std::memory_order_relaxed);
+        for (std::size_t i = 0; i != m_participants_count; ++i) {
+            auto first = static_cast<std::uint32_t>(sz * i /
+                                                    m_participants_count);
+            auto last = static_cast<std::uint32_t>(sz * (i + 1) /
+                                                   m_participants_count);
 
-            if (block < 0)
-                break;
+            m_participants[i].range.store(pack(first, last),
+                                          std::memory_order_release);
+        }
 
-            std::size_t begin = block * m_block_size;
-            std::size_t begin_plus_b = begin + m_block_size;
-            std::size_t end = std::min(m_jobs->size(), begin_plus_b);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_generation.fetch_add(1, std::memory_order_release);
+            if (m_parked > 0)
+                m_wakeup.notify_all();
+        }
 
-            for (; begin < end; ++begin)
-                simulator_process((*m_jobs)[begin], m_time);
+        work(0);
 
-            m_block_count.fetch_sub(1, std::memory_order_relaxed);
-        }
+        for (unsigned i = 0; i != spin_min; ++i)
+            if (m_remaining.load(std::memory_order_acquire) == 0)
+                break;
 
-        while (m_block_count.load(std::memory_order_relaxed) >= 0)
-            std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+        if (m_remaining.load(std::memory_order_acquire) != 0) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this]() {
+                return m_remaining.load(std::memory_order_acquire) == 0;
+            });
+        }
 
         m_jobs = nullptr;
+    }
 
-        return true;
+    void stop() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop.store(true, std::memory_order_relaxed);
+            m_wakeup.notify_all();
+        }
+
+        for (auto& thread : m_workers)
+            if (thread.joinable())
+                thread.join();
     }
 };
 }
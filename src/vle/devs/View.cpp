@@ -26,6 +26,8 @@
 
 #include <vle/devs/Dynamics.hpp>
 #include <vle/utils/Algo.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
 #include <vle/vpz/CoupledModel.hpp>
 
 #include "devs/View.hpp"
@@ -37,6 +39,19 @@
 namespace vle {
 namespace devs {
 
+std::unique_ptr<value::Value>
+ScalarObservation::toValue() const
+{
+    switch (m_type) {
+    case Type::REAL:
+        return value::Double::create(m_real);
+    case Type::INTEGER:
+        return value::Integer::create(m_integer);
+    default:
+        return {};
+    }
+}
+
 void
 View::open(utils::ContextPtr ctx,
            const std::string& name,
@@ -101,13 +116,14 @@ View::addObservable(Dynamics* dynamics,
     assert(not exist(dynamics, portname));
     assert(m_plugin);
 
-    m_observableList.emplace(dynamics, portname);
+    auto handle =
+      m_plugin->onNewObservableHandle(dynamics->getModel().getName(),
+                                      dynamics->getModel().getParentName(),
+                                      portname,
+                                      m_name,
+                                      currenttime);
 
-    m_plugin->onNewObservable(dynamics->getModel().getName(),
-                              dynamics->getModel().getParentName(),
-                              portname,
-                              m_name,
-                              currenttime);
+    m_observableList.emplace(dynamics, Observable{ portname, handle });
 }
 
 void
@@ -121,7 +137,7 @@ View::removeObservable(Dynamics* dynamics)
     for (auto it = result.first; it != result.second; ++it)
         m_plugin->onDelObservable(it->first->getModel().getName(),
                                   it->first->getModel().getParentName(),
-                                  it->second,
+                                  it->second.portname,
                                   m_name,
                                   0.0);
 
@@ -134,7 +150,7 @@ View::exist(Dynamics* dynamics, const std::string& portname) const
     auto result = m_observableList.equal_range(dynamics);
 
     for (auto it = result.first; it != result.second; ++it)
-        if (it->second == portname)
+        if (it->second.portname == portname)
             return true;
 
     return false;
@@ -146,19 +162,68 @@ View::exist(Dynamics* dynamics) const
     return m_observableList.find(dynamics) != m_observableList.end();
 }
 
+void
+View::send(const Dynamics* dynamics,
+           const Observable& obs,
+           Time current,
+           std::unique_ptr<value::Value> value)
+{
+    if (obs.handle >= 0)
+        m_plugin->onHandleValue(obs.handle, current, std::move(value));
+    else
+        m_plugin->onValue(dynamics->getModel().getName(),
+                          dynamics->getModel().getParentName(),
+                          obs.portname,
+                          m_name,
+                          current,
+                          std::move(value));
+}
+
+void
+View::send(const Dynamics* dynamics,
+           const Observable& obs,
+           Time current,
+           const ScalarObservation& scalar)
+{
+    if (obs.handle < 0)
+        send(dynamics, obs, current, scalar.toValue());
+    else if (scalar.type() == ScalarObservation::Type::REAL)
+        m_plugin->onHandleReal(obs.handle, current, scalar.real());
+    else
+        m_plugin->onHandleInteger(obs.handle, current, scalar.integer());
+}
+
+const View::Observable*
+View::find(const Dynamics* dynamics, const std::string& port) const
+{
+    auto result =
+      m_observableList.equal_range(const_cast<Dynamics*>(dynamics));
+
+    for (auto it = result.first; it != result.second; ++it)
+        if (it->second.portname == port)
+            return &it->second;
+
+    return nullptr;
+}
+
 void
 View::run(Time time)
 {
     if (not m_observableList.empty()) {
+        ScalarObservation scalar;
+
         for (auto& elem : m_observableList) {
-            ObservationEvent event(time, m_name, elem.second);
-            auto val = elem.first->observation(event);
-            m_plugin->onValue(elem.first->getModel().getName(),
-                              elem.first->getModel().getParentName(),
-                              elem.second,
-                              m_name,
-                              time,
-                              std::move(val));
+            ObservationEvent event(time, m_name, elem.second.portname);
+
+            scalar.reset();
+            elem.first->scalarObservation(event, scalar);
+            if (scalar)
+                send(elem.first, elem.second, time, scalar);
+            else
+                send(elem.first,
+                     elem.second,
+                     time,
+                     elem.first->observation(event));
         }
     } else {
         //
@@ -172,15 +237,15 @@ View::run(Time time)
 void
 View::run(const Dynamics* dynamics, Time current, const std::string& port)
 {
+    Observation observation;
     ObservationEvent event(current, m_name, port);
-    auto val = dynamics->observation(event);
 
-    m_plugin->onValue(dynamics->getModel().getName(),
-                      dynamics->getModel().getParentName(),
-                      port,
-                      m_name,
-                      current,
-                      std::move(val));
+    observation.portname = port;
+    dynamics->scalarObservation(event, observation.scalar);
+    if (not observation.scalar)
+        observation.value = dynamics->observation(event);
+
+    run(dynamics, current, observation);
 }
 
 void
@@ -189,12 +254,41 @@ View::run(const Dynamics* dynamics,
           const std::string& port,
           std::unique_ptr<value::Value> value)
 {
-    m_plugin->onValue(dynamics->getModel().getName(),
-                      dynamics->getModel().getParentName(),
-                      port,
-                      m_name,
-                      current,
-                      std::move(value));
+    const auto* obs = find(dynamics, port);
+
+    if (obs)
+        send(dynamics, *obs, current, std::move(value));
+    else
+        m_plugin->onValue(dynamics->getModel().getName(),
+                          dynamics->getModel().getParentName(),
+                          port,
+                          m_name,
+                          current,
+                          std::move(value));
+}
+
+void
+View::run(const Dynamics* dynamics, Time current, Observation& observation)
+{
+    if (not observation.scalar) {
+        run(dynamics,
+            current,
+            observation.portname,
+            std::move(observation.value));
+        return;
+    }
+
+    const auto* obs = find(dynamics, observation.portname);
+
+    if (obs)
+        send(dynamics, *obs, current, observation.scalar);
+    else
+        m_plugin->onValue(dynamics->getModel().getName(),
+                          dynamics->getModel().getParentName(),
+                          observation.portname,
+                          m_name,
+                          current,
+                          observation.scalar.toValue());
 }
 
 std::unique_ptr<value::Matrix>
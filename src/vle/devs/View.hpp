@@ -27,9 +27,11 @@
 #ifndef VLE_DEVS_VIEW_HPP
 #define VLE_DEVS_VIEW_HPP 1
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vle/DllDefines.hpp>
+#include <vle/devs/ObservationEvent.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/oov/Plugin.hpp>
 #include <vle/utils/Context.hpp>
@@ -43,13 +45,15 @@ class View;
 
 /**
  * A simple structure that stores observation values for a specific view
- * and portname tuple.
+ * and portname tuple. The \e scalar is used instead of \e value if the
+ * model assigns it with \e Dynamics::scalarObservation.
  */
 struct Observation
 {
     View* view = nullptr;
     std::string portname;
     std::unique_ptr<value::Value> value;
+    ScalarObservation scalar;
 };
 
 /**
@@ -115,6 +119,15 @@ public:
              const std::string& port,
              std::unique_ptr<value::Value> value);
 
+    /**
+     * Send the \e observation computed by the \e DynamicsObserver. A
+     * scalar observation is sent without allocation if the plug-in uses
+     * handles.
+     */
+    void run(const Dynamics* dynamics,
+             Time current,
+             Observation& observation);
+
     /**
      * Delete an observable for a specified Dynamics. If model does not
      * exist, nothing is produce otherwise, the stream receives a message
@@ -168,7 +181,40 @@ public:
     std::unique_ptr<value::Matrix> finish(Time current);
 
 protected:
-    using ObservableList = std::multimap<Dynamics*, std::string>;
+    /**
+     * An observed port of a \e Dynamics with the handle returned by the
+     * plug-in (-1 if the plug-in uses the names).
+     */
+    struct Observable
+    {
+        std::string portname;
+        std::int32_t handle;
+    };
+
+    using ObservableList = std::multimap<Dynamics*, Observable>;
+
+    /**
+     * Send the \e value of the observable \e obs of the \e dynamics to
+     * the plug-in.
+     */
+    void send(const Dynamics* dynamics,
+              const Observable& obs,
+              Time current,
+              std::unique_ptr<value::Value> value);
+
+    /**
+     * Send the real or the integer \e scalar to the plug-in.
+     */
+    void send(const Dynamics* dynamics,
+              const Observable& obs,
+              Time current,
+              const ScalarObservation& scalar);
+
+    /**
+     * Get the observable of the \e dynamics on the \e port.
+     */
+    const Observable* find(const Dynamics* dynamics,
+                           const std::string& port) const;
 
     ObservableList m_observableList;
     std::string m_name;
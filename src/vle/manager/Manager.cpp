@@ -25,6 +25,7 @@
  */
 
 #include <vle/manager/Manager.hpp>
+#include <vle/manager/PreparedSimulation.hpp>
 #include <vle/manager/Simulation.hpp>
 #include <vle/utils/Package.hpp>
 #include <vle/utils/Exception.hpp>
@@ -48,6 +49,7 @@
 #include "utils/ContextPrivate.hpp"
 #include "manager/details/wrapper_init.hpp"
 #include "manager/details/manager_concepts.hpp"
+#include "manager/details/integration_plugin.hpp"
 #include "manager/details/manager_initializations.hpp"
 #include "manager/details/thread_specific.hpp"
 #include "manager/details/cvle_specific.hpp"
@@ -134,6 +136,11 @@ public:
         checkSimulationOption();
         checkParallelOption();
         set_seed(seed);
+
+        mContext->add_oov_factory(IntegrationPlugin::factoryName(),
+                [](const std::string& location) {
+                    return new IntegrationPlugin(location);
+                });
     }
 
     void
@@ -227,6 +234,158 @@ public:
     }
 
 
+    /********************************************************/
+    ///read the expected duration of each input from the plan
+    bool
+    expected_durations(const wrapper_init& init, unsigned int inputSize,
+            std::vector<double>& durations, manager::Error& err)
+    {
+        bool status = true;
+        if (not init.exist("expected_duration", status)) {
+            return false;
+        }
+        const value::Value& exp = init.get("expected_duration", status);
+        durations.resize(inputSize);
+        try {
+            for (unsigned int i = 0; i < inputSize; i++) {
+                if (exp.isTuple()) {
+                    durations[i] = exp.toTuple().at(i);
+                } else if (exp.isSet()) {
+                    durations[i] = value::toDouble(exp.toSet().get(i));
+                } else {
+                    durations[i] = value::toDouble(exp);
+                }
+            }
+        } catch (const std::exception& e) {
+            err.code = -1;
+            err.message = "[Manager] error in 'expected_duration': ";
+            err.message += e.what();
+            return false;
+        }
+        return true;
+    }
+
+    /********************************************************/
+    ///run the simulations of the plan with nbslots thread workers
+    void
+    run_workers(
+            const vpz::Vpz& model,
+            ManagerObjects& manObj,
+            const wrapper_init& init,
+            value::Map& results,
+            const Manager::result_function* output,
+            unsigned int nbslots,
+            manager::Error& err)
+    {
+        unsigned int inputSize = manObj.inputsSize();
+        unsigned int repSize = manObj.replicasSize();
+
+        simulation_queue queue(inputSize*repSize);
+        std::vector<double> durations;
+        if (expected_durations(init, inputSize, durations, err)) {
+            queue.sort(durations, repSize);
+        }
+        if (err.code) {
+            return;
+        }
+
+        std::vector<thread_usage> usages(nbslots);
+        std::mutex results_mutex;
+        auto start = std::chrono::steady_clock::now();
+
+        if (nbslots == 1) {
+            thread_worker worker(mContext, model, init, manObj,
+                    manObj.mOutputs, results, results_mutex, mTimeout,
+                    mSimulationoption, queue, usages[0], err, output);
+            worker();
+        } else {
+            //each thread aggregates into its own outputs, merged at the end
+            std::vector<std::vector<std::unique_ptr<ManOutput>>>
+                    outputs(nbslots);
+            std::vector<value::Map> partials(nbslots);
+            std::vector<std::thread> gp;
+            for (uint32_t i = 0; i < nbslots; ++i) {
+                for (auto& out : manObj.mOutputs) {
+                    outputs[i].emplace_back(out->clone());
+                }
+                utils::ContextPtr ctx = mContext->clone();
+                ctx->set_log_function(
+                        std::unique_ptr<utils::Context::LogFunctor>(
+                                new thread_log(i)));
+                gp.emplace_back(thread_worker(ctx, model, init,
+                        manObj, outputs[i], partials[i], results_mutex,
+                        mTimeout, mSimulationoption, queue, usages[i], err,
+                        output));
+            }
+
+            for (uint32_t i = 0; i < nbslots; ++i)
+                gp[i].join();
+
+            if (not output and not err.code) {
+                merge_outputs(outputs, partials, results, err);
+            }
+        }
+
+        std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+        for (uint32_t i = 0; i < nbslots; ++i) {
+            std::chrono::duration<double> busy = usages[i].busy;
+            mContext->log(VLE_LOG_NOTICE, "[Manager] thread %u: %u simus,"
+                    " busy %fs (%.1f%%)\n", i, usages[i].simulations,
+                    busy.count(), elapsed.count() > 0.0 ?
+                            100.0 * busy.count() / elapsed.count() : 0.0);
+        }
+    }
+
+    /********************************************************/
+    ///true if outputs can be integrated during the simulations: the
+    ///IntegrationPlugin is only known by the context of this process
+    bool
+    integrate_in_simulation() const
+    {
+        return not (mSimulationoption & SIMULATION_SPAWN_PROCESS);
+    }
+
+    /********************************************************/
+    ///merge the outputs aggregated separately by the thread workers
+    void
+    merge_outputs(
+            std::vector<std::vector<std::unique_ptr<ManOutput>>>& outputs,
+            std::vector<value::Map>& partials,
+            value::Map& results,
+            manager::Error& err)
+    {
+        try {
+            for (unsigned int o = 0; o < outputs[0].size(); o++) {
+                const std::string& id = outputs[0][o]->id;
+                ManOutput* base = nullptr;
+                for (unsigned int w = 0; w < outputs.size(); w++) {
+                    //the output is complete if one thread did all simus
+                    value::Map::iterator it = partials[w].find(id);
+                    if (it != partials[w].end() and it->second) {
+                        results.set(id, std::move(it->second));
+                    }
+                    ManOutput& out = *outputs[w][o];
+                    if (not out.delegate) {
+                        continue;
+                    }
+                    if (not base) {
+                        base = &out;
+                        continue;
+                    }
+                    std::unique_ptr<value::Value> aggr = base->merge(out);
+                    if (aggr) {
+                        results.set(id, std::move(aggr));
+                    }
+                }
+            }
+        } catch (const std::exception& e) {
+            err.code = -1;
+            err.message = "[Manager error] aggregation merge : ";
+            err.message += e.what();
+        }
+    }
+
     /********************************************************/
     ///run plan without parallelization
     std::unique_ptr<value::Map>
@@ -236,7 +395,8 @@ public:
             const wrapper_init& init,
             manager::Error& err)
     {
-        init_embedded_model(*model, *manObj, init, err);
+        init_embedded_model(*model, *manObj, init, err,
+                integrate_in_simulation(), true);
         if (err.code) {
             return nullptr;
         }
@@ -252,13 +412,7 @@ public:
         mContext->log(VLE_LOG_NOTICE, "[Manager] simulation mono nb simus:"
                 " %u \n", (repSize*inputSize));
 
-        std::vector<std::thread> gp;
-        std::mutex results_mutex;
-
-        thread_worker worker = thread_worker(mContext, *model, init,
-                *manObj, manObj->mOutputs, *results, results_mutex,
-                mTimeout, mSimulationoption, 0, 1, err);
-        worker();
+        run_workers(*model, *manObj, init, *results, nullptr, 1, err);
         if (err.code) {
             return nullptr;
         }
@@ -276,7 +430,8 @@ public:
             const wrapper_init& init,
             manager::Error& err)
     {
-        init_embedded_model(*model, *manObj, init, err);
+        init_embedded_model(*model, *manObj, init, err,
+                integrate_in_simulation(), true);
         if (err.code) {
             return nullptr;
         }
@@ -293,20 +448,8 @@ public:
                 " (%d threads) nb simus: %u \n", mNbslots,
                 (repSize*inputSize));
 
-        std::vector<std::thread> gp;
-        std::mutex results_mutex;
-        for (uint32_t i = 0; i < mNbslots; ++i) {
-            utils::ContextPtr ctx = mContext->clone();
-            ctx->set_log_function(std::unique_ptr<utils::Context::LogFunctor>(
-                    new thread_log(i)));
-            gp.emplace_back(thread_worker(ctx, *model, init,
-                    *manObj, manObj->mOutputs, *results, results_mutex,
-                    mTimeout, mSimulationoption, i, mNbslots, err));
-        }
-
-        for (uint32_t i = 0; i < mNbslots; ++i)
-            gp[i].join();
-
+        run_workers(*model, *manObj, init, *results, nullptr, mNbslots,
+                err);
         if (err.code) {
             return nullptr;
         }
@@ -316,6 +459,45 @@ public:
         return results;
     }
 
+    /********************************************************/
+    ///run plan without aggregation, results are given to output
+    void
+    run_with_output(
+            std::unique_ptr<vpz::Vpz> model,
+            std::unique_ptr<ManagerObjects> manObj,
+            const wrapper_init& init,
+            const Manager::result_function& output,
+            manager::Error& err)
+    {
+        //views of the model are kept: no call to config_views
+        post_define(*model, manObj->mDefine, err);
+        if (err.code) {
+            return;
+        }
+        post_propagates(*model, manObj->mPropagate, init, err);
+        if (err.code) {
+            return;
+        }
+
+        unsigned int inputSize = manObj->inputsSize();
+        unsigned int repSize = manObj->replicasSize();
+        unsigned int nbslots =
+                mParalleloption == PARALLEL_THREADS ? mNbslots : 1;
+
+        mContext->log(VLE_LOG_NOTICE, "[Manager] simulation without "
+                "aggregation (%u threads) nb simus: %u \n", nbslots,
+                (repSize*inputSize));
+
+        value::Map results;
+        run_workers(*model, *manObj, init, results, &output, nbslots, err);
+        if (err.code) {
+            return;
+        }
+
+        mContext->log(VLE_LOG_NOTICE, "[Manager] end simulation without"
+                " aggregation\n");
+    }
+
     /********************************************************/
     /// run Plan with cvle
     std::unique_ptr<value::Map>
@@ -351,8 +533,8 @@ public:
         }
 
         //define output file
-        utils::Path  tempOutCsv = make_temp(
-                "vle-rec-%%%%-%%%%-%%%%-%%%%-out.csv", mWorkingDir);
+        utils::Path  tempOut = make_temp(
+                "vle-rec-%%%%-%%%%-%%%%-%%%%-out.bin", mWorkingDir);
 
         //launch mpirun
         utils::Spawn mspawn(mContext);
@@ -377,7 +559,7 @@ public:
         if (mSimulationoption != SIMULATION_SPAWN_PROCESS) {
             argv.push_back("--withoutspawn");
         }
-        argv.push_back("--more-output-details");
+        argv.push_back("--binary-output");
         ////use mpi_warn_nf_forgk since cvle launches simulation with fork
         //// if withspawn (?)
         //argv.push_back("--mca");
@@ -400,7 +582,7 @@ public:
         argv.push_back("-i");
         argv.push_back(tempInCsv.string());
         argv.push_back("-o");
-        argv.push_back(tempOutCsv.string());
+        argv.push_back(tempOut.string());
 
         if (mContext->get_log_priority() >= VLE_LOG_INFO) {
             std::string messageDbg ="";
@@ -413,7 +595,8 @@ public:
                     mWorkingDir.c_str(), exe.c_str(), messageDbg.c_str());
         }
 
-        bool started = mspawn.start(exe, mWorkingDir, argv);
+        bool started = mspawn.start(exe, mWorkingDir, argv,
+                std::chrono::milliseconds::zero());
         if (not started) {
             err.code = -1;
             err.message = vle::utils::format(
@@ -421,19 +604,13 @@ public:
             return nullptr;
         }
         bool is_success = true;
-        std::string output, error;
-        while (not mspawn.isfinish()) {
-            if (mspawn.get(&output, &error)) {
-                mContext->log(VLE_LOG_INFO, output);
-                output.clear();
-                mContext->log(VLE_LOG_INFO, error);
-                error.clear();
-                std::this_thread::sleep_for(std::chrono::microseconds(200));
-            } else {
-                break;
-            }
-        }
-        mspawn.wait();
+        std::string error;
+        mspawn.wait([this](const std::string& out, const std::string& err) {
+                    if (not out.empty())
+                        mContext->log(VLE_LOG_INFO, out);
+                    if (not err.empty())
+                        mContext->log(VLE_LOG_INFO, err);
+                }, std::chrono::milliseconds::zero());
         mspawn.status(&error, &is_success);
         if (! is_success) {
             err.code = -1;
@@ -445,7 +622,7 @@ public:
         mContext->log(VLE_LOG_NOTICE,
                 "[Manager] simulation with mpi performed\n");
         //read output file
-        std::unique_ptr<value::Map> results = cvle_read(tempOutCsv,
+        std::unique_ptr<value::Map> results = cvle_read_binary(tempOut,
                 inputSize, repSize, manObj->mOutputs, err);
         if (err.code) {
             return nullptr;
@@ -453,7 +630,7 @@ public:
         mContext->log(VLE_LOG_NOTICE,
                 "[Manager] results aggregation performed\n");
         if (mRemoveMPIfiles) {
-            tempOutCsv.remove();
+            tempOut.remove();
             tempInCsv.remove();
             tempVpzPath.remove();
             if (mGenerateMPIhost) {
@@ -615,7 +792,22 @@ public:
         return nullptr;
     }
 
-
+    // run wrapper without aggregation
+    void
+    runPlan(std::unique_ptr<vpz::Vpz> model, wrapper_init& init,
+            const Manager::result_function& output, manager::Error& err)
+    {
+        std::unique_ptr<ManagerObjects> manObj = init_from_plan(init, err);
+        if (err.code) return;
+        if (mParalleloption == PARALLEL_MPI) {
+            err.code = -1;
+            err.message = "[Manager] simulation without aggregation is not "
+                    "available with mpi";
+            return;
+        }
+        run_with_output(std::move(model), std::move(manObj), init, output,
+                err);
+    }
 
 };
 
@@ -719,6 +911,16 @@ Manager::runPlan(std::unique_ptr<vpz::Vpz> model
     return mPimpl->runPlan(std::move(model), init_rec, err);
 }
 
+void
+Manager::runPlan(std::unique_ptr<vpz::Vpz> model
+        , const vle::value::Map& init
+        , const result_function& output
+        , manager::Error& err)
+{
+    wrapper_init init_rec(&init);
+    mPimpl->runPlan(std::move(model), init_rec, output, err);
+}
+
 //specific getEmbedded signatures
 std::unique_ptr<vpz::Vpz>
 Manager::getEmbedded(const vle::value::Map& init, Error& err,
@@ -0,0 +1,165 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/manager/PreparedSimulation.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Tools.hpp>
+
+#include "devs/ModelFactory.hpp"
+#include "devs/RootCoordinator.hpp"
+#include "utils/ContextPrivate.hpp"
+#include "utils/i18n.hpp"
+
+#include <utility>
+
+namespace vle {
+namespace manager {
+
+class PreparedSimulation::Pimpl
+{
+public:
+    utils::ContextPtr m_context;
+    std::unique_ptr<vpz::Vpz> m_vpz;
+    std::shared_ptr<devs::ModelSymbols> m_symbols;
+
+    Pimpl(utils::ContextPtr context, std::unique_ptr<vpz::Vpz> vpz)
+      : m_context(std::move(context))
+      , m_vpz(std::move(vpz))
+      , m_symbols(std::make_shared<devs::ModelSymbols>())
+    {
+        if (not m_vpz)
+            throw utils::ArgError(_("PreparedSimulation: missing vpz"));
+    }
+
+    void prepare(Error* error)
+    {
+        try {
+            for (const auto& elem :
+                 m_vpz->project().dynamics().dynamiclist())
+                m_symbols->get(m_context, elem.second);
+
+            const auto& outputs =
+              m_vpz->project().experiment().views().outputs();
+            for (const auto& elem : outputs.outputlist()) {
+                if (elem.second.package().empty())
+                    continue;
+
+                utils::get_symbol(m_context,
+                                  elem.second.package(),
+                                  elem.second.plugin(),
+                                  utils::Context::ModuleType::MODULE_OOV);
+            }
+
+            error->code = 0;
+        } catch (const std::exception& e) {
+            error->message =
+              utils::format(_("\n/!\\ error reported: %s\n"), e.what());
+            error->code = -1;
+        }
+    }
+
+    std::unique_ptr<value::Map> run(Error* error)
+    {
+        std::unique_ptr<value::Map> result;
+
+        try {
+            devs::RootCoordinator root(m_context);
+
+            //
+            // The coordinator takes the ownership of the graph of models:
+            // we give it a copy and the prepared vpz stays unchanged.
+            //
+
+            vpz::Model model(m_vpz->project().model());
+            root.load(m_vpz->project(), model, m_symbols);
+
+            root.init();
+            while (root.run()) {
+            }
+            result = root.finish();
+
+            error->code = 0;
+        } catch (const std::exception& e) {
+            error->message =
+              utils::format(_("\n/!\\ error reported: %s\n"), e.what());
+            error->code = -1;
+        }
+
+        return result;
+    }
+};
+
+PreparedSimulation::PreparedSimulation(utils::ContextPtr context,
+                                       std::unique_ptr<vpz::Vpz> vpz)
+  : mPimpl(std::make_unique<PreparedSimulation::Pimpl>(std::move(context),
+                                                       std::move(vpz)))
+{}
+
+PreparedSimulation::~PreparedSimulation() = default;
+
+void
+PreparedSimulation::setConditionPort(const std::string& condition,
+                                     const std::string& port,
+                                     std::shared_ptr<value::Value> value)
+{
+    mPimpl->m_vpz->project()
+      .experiment()
+      .conditions()
+      .get(condition)
+      .setValueToPort(port, std::move(value));
+}
+
+void
+PreparedSimulation::setInstance(int instance)
+{
+    mPimpl->m_vpz->project().setInstance(instance);
+}
+
+const vpz::Vpz&
+PreparedSimulation::vpz() const
+{
+    return *mPimpl->m_vpz;
+}
+
+vpz::Vpz&
+PreparedSimulation::vpz()
+{
+    return *mPimpl->m_vpz;
+}
+
+void
+PreparedSimulation::prepare(Error* error)
+{
+    mPimpl->prepare(error);
+}
+
+std::unique_ptr<value::Map>
+PreparedSimulation::run(Error* error)
+{
+    return mPimpl->run(error);
+}
+}
+}
@@ -28,8 +28,11 @@
 #include <vle/manager/Simulation.hpp>
 #include <vle/utils/Spawn.hpp>
 #include <vle/utils/Tools.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Map.hpp>
 
 #include "devs/RootCoordinator.hpp"
+#include "manager/details/simulation_server.hpp"
 #include "utils/ContextPrivate.hpp"
 #include "utils/i18n.hpp"
 
@@ -67,12 +70,24 @@ make_temp(const char* format)
 std::unique_ptr<value::Map>
 read_value(const utils::Path& p)
 {
-    std::ifstream ifs(p.string());
+    std::ifstream ifs(p.string(), std::ios::in | std::ios::binary);
     if (ifs.is_open()) {
         std::stringstream ss;
         ss << ifs.rdbuf();
         std::string buffer(ss.str());
 
+        // The simulation command writes the binary encoding of the values
+        // (--binary-output), older settings write XML.
+        if (value::isBinary(buffer.data(), buffer.size())) {
+            auto v = value::readBinary(buffer.data(), buffer.size());
+            if (v->isMap()) {
+                return std::unique_ptr<value::Map>(
+                  static_cast<value::Map*>(v.release()));
+            }
+
+            return std::unique_ptr<value::Map>{};
+        }
+
         auto v = vpz::Vpz::parseValue(buffer);
         if (v and v->isMap()) {
             return std::make_unique<value::Map>(v->toMap());
@@ -90,6 +105,14 @@ public:
     utils::UnlinkPath m_vpz_file;
     utils::UnlinkPath m_output_file;
     SimulationOptions m_simulationoptions;
+#ifndef _WIN32
+    std::unique_ptr<simulation_server> m_server;
+    bool m_server_disabled = false;
+    int m_server_failures = 0; /*!< consecutive failed runs. */
+
+    /** Number of consecutive failed runs which disables the server. */
+    static constexpr int server_max_failures = 3;
+#endif
 
     Pimpl(utils::ContextPtr context,
           SimulationOptions simulationoptionts,
@@ -200,6 +223,21 @@ public:
                     _(" - Time spent in kernel .........: %f s\n"),
                     timer.elapsed()));
 
+            auto stats = root.statistics();
+            if (stats.jobs or stats.sequential or stats.small) {
+                m_context->notice(utils::format(
+                  _(" - Parallel bags ................: %llu "
+                    "(mean block size: %f)\n"),
+                  static_cast<unsigned long long>(stats.jobs),
+                  stats.block_size));
+                m_context->notice(utils::format(
+                  _(" - Sequential bags ..............: %llu "
+                    "(too small: %llu)\n"),
+                  static_cast<unsigned long long>(stats.sequential +
+                                                  stats.small),
+                  static_cast<unsigned long long>(stats.small)));
+            }
+
             error->code = 0;
         } catch (const std::exception& e) {
             error->message =
@@ -237,9 +275,59 @@ public:
         return result;
     }
 
+    /**
+     * Run the simulation into the simulation server of this @c Simulation
+     * (started at the first call).
+     *
+     * @return false if the server is not available.
+     */
+    bool runServer(const vpz::Vpz& vpz,
+                   std::unique_ptr<value::Map>& result,
+                   Error* error)
+    {
+#ifndef _WIN32
+        if (m_server_disabled)
+            return false;
+
+        if (not m_server)
+            m_server = std::make_unique<simulation_server>(m_context);
+
+        if (not m_server->is_running() and not m_server->start()) {
+            m_server_disabled = true;
+            return false;
+        }
+
+        if (m_server->run(vpz, m_timeout, result, error)) {
+            m_server_failures = 0;
+            return true;
+        }
+
+        if (++m_server_failures >= server_max_failures) {
+            m_server_disabled = true;
+            m_context->warning(_("Simulation server: connection lost %d "
+                                 "times, server disabled\n"),
+                               m_server_failures);
+        } else {
+            m_context->warning(_("Simulation server: connection lost,"
+                                 " restart with the next simulation\n"));
+        }
+#else
+        (void)vpz;
+        (void)result;
+        (void)error;
+#endif
+        return false;
+    }
+
     std::unique_ptr<value::Map> runSubProcess(std::unique_ptr<vpz::Vpz> vpz,
                                               Error* error)
     {
+        {
+            std::unique_ptr<value::Map> result;
+            if (runServer(*vpz, result, error))
+                return result;
+        }
+
         auto pwd = utils::Path::current_path();
         std::string command;
 
@@ -255,65 +343,34 @@ public:
             auto exe = std::move(argv.front());
             argv.erase(argv.begin());
 
-            if (not spawn.start(exe, pwd.string(), argv, m_timeout)) {
+            if (not spawn.start(
+                  exe, pwd.string(), argv, std::chrono::milliseconds::zero())) {
                 error->code = -1;
                 error->message = "fail to spawn";
                 return {};
             }
 
-            std::string output, err;
             std::string message;
             bool success;
 
-            if (m_timeout != std::chrono::milliseconds::zero()) {
-                auto duration = m_timeout;
-                auto starttime = std::chrono::system_clock::now();
-
-                while (not spawn.isfinish()) {
-                    if (spawn.get(&output, &err)) {
-                        if (not output.empty()) {
-                            m_context->info("%s", output.c_str());
-                        }
-                        if (not err.empty()) {
-                            m_context->error("%s", err.c_str());
-                        }
-                        output.clear();
-                        err.clear();
-
-                        std::this_thread::sleep_for(
-                          std::chrono::microseconds(200));
-
-                        auto endtime = std::chrono::system_clock::now();
-                        auto elapsed = endtime - starttime;
-                        if (elapsed > duration) {
-                            printf("kill process. Too long\n");
-                            spawn.kill();
-                            break;
-                        }
-                    } else {
-                        break;
-                    }
-                }
-            } else {
-                while (not spawn.isfinish()) {
-                    if (spawn.get(&output, &err)) {
-                        if (not output.empty()) {
-                            m_context->info("%s", output.c_str());
-                        }
-                        if (not err.empty()) {
-                            m_context->error("%s", err.c_str());
-                        }
-                        output.clear();
-                        err.clear();
-
-                        std::this_thread::sleep_for(
-                          std::chrono::microseconds(200));
-                    } else {
-                        break;
-                    }
-                }
-            }
-            spawn.wait();
+            //
+            // The outputs of the sub-process are logged as soon as they are
+            // read. The sub-process is killed if it does not end before the
+            // timeout (if not zero).
+            //
+
+            auto log = [this](const std::string& output,
+                              const std::string& err) {
+                if (not output.empty())
+                    m_context->info("%s", output.c_str());
+                if (not err.empty())
+                    m_context->error("%s", err.c_str());
+            };
+
+            if (not spawn.wait(log, m_timeout))
+                m_context->error(_("VLE sub process: killed after %ld ms\n"),
+                                 static_cast<long>(m_timeout.count()));
+
             spawn.status(&message, &success);
 
             if (not success and not message.empty()) {
@@ -353,6 +410,18 @@ Simulation::Simulation(utils::ContextPtr context,
 
 Simulation::~Simulation() = default;
 
+bool
+Simulation::serve(utils::ContextPtr context, int fd)
+{
+#ifndef _WIN32
+    return server_serve(context, fd);
+#else
+    context->error(_("Simulation server: not available\n"));
+    (void)fd;
+    return false;
+#endif
+}
+
 std::unique_ptr<value::Map>
 Simulation::run(std::unique_ptr<vpz::Vpz> vpz, Error* error)
 {
@@ -28,6 +28,8 @@
 
 #include <vle/utils/Exception.hpp>
 
+#include "quantile_sketch.hpp"
+
 namespace vle {
 namespace manager {
 
@@ -41,7 +43,8 @@ enum AccuType
     STANDARD, //computes mean, std, var, min, max
     MEAN,     //compute mean only
     QUANTILE,  //compute quantiles
-    ORDERED   //keep order: can access to specific value
+    ORDERED,   //keep order: can access to specific value
+    SKETCH    //estimate quantiles with bounded memory, mean, min, max
 };
 
 /**
@@ -70,7 +73,7 @@ public:
     /**
      * @brief gives the optimal storage for a wanted statistics
      */
-    static AccuType storageTypeForStat(AccuStat s)
+    static AccuType storageTypeForStat(AccuStat s, bool sketch = false)
     {
         switch(s){
         case S_mean:
@@ -95,7 +98,7 @@ public:
             return ORDERED;
             break;
         case S_quantile:
-            return QUANTILE;
+            return sketch ? SKETCH : QUANTILE;
             break;
         }
         return STANDARD;
@@ -109,7 +112,8 @@ public:
         accu(STANDARD),  msum(0), mcount(0), msquareSum(0),
         mmin(std::numeric_limits<double>::max()),
         mmax(std::numeric_limits<double>::min()),
-        msorted(false), mvalues(nullptr), mquantile(0.5), mat(0)
+        msorted(false), mvalues(nullptr), msketch(nullptr), mquantile(0.5),
+        mat(0)
     {
     }
 
@@ -121,7 +125,8 @@ public:
         accu(type), msum(0), mcount(0), msquareSum(0),
         mmin(std::numeric_limits<double>::max()),
         mmax(std::numeric_limits<double>::min()),
-        msorted(false), mvalues(nullptr), mquantile(0.5), mat(0)
+        msorted(false), mvalues(nullptr), msketch(nullptr), mquantile(0.5),
+        mat(0)
     {
         if (accu == ORDERED or accu == QUANTILE) {
             mvalues.reset(new std::vector<double>());
@@ -129,26 +134,35 @@ public:
         if (accu == QUANTILE) {
             msorted = true;
         }
+        if (accu == SKETCH) {
+            msketch.reset(new QuantileSketch());
+        }
     }
 
     /**
      * @brief constructor with the wanted statistic
      * The storage is optimized according the wanted statistic
      * @param s, the AccuStat
+     * @param sketch, if true quantiles are estimated with bounded memory
+     * (see QuantileSketch)
      */
-    AccuMono(AccuStat s) :
+    AccuMono(AccuStat s, bool sketch = false) :
         accu(), msum(0), mcount(0), msquareSum(0),
         mmin(std::numeric_limits<double>::max()),
         mmax(std::numeric_limits<double>::min()),
-        msorted(false), mvalues(nullptr), mquantile(0.5), mat(0)
+        msorted(false), mvalues(nullptr), msketch(nullptr), mquantile(0.5),
+        mat(0)
     {
-        accu = AccuMono::storageTypeForStat(s);
+        accu = AccuMono::storageTypeForStat(s, sketch);
         if (accu == ORDERED or accu == QUANTILE) {
             mvalues.reset(new std::vector<double>());
         }
         if (accu == QUANTILE) {
             msorted = true;
         }
+        if (accu == SKETCH) {
+            msketch.reset(new QuantileSketch());
+        }
     }
 
     /**
@@ -158,12 +172,16 @@ public:
     AccuMono(const AccuMono& acc):
         accu(acc.accu), msum(acc.msum), mcount(acc.mcount),
         msquareSum(acc.msquareSum), mmin(acc.mmin),  mmax(acc.mmax),
-        msorted(acc.msorted), mvalues(nullptr), mquantile(0.5), mat(0)
+        msorted(acc.msorted), mvalues(nullptr), msketch(nullptr),
+        mquantile(acc.mquantile), mat(acc.mat)
     {
         if (acc.mvalues) {
             mvalues.reset(new std::vector<double>(acc.mvalues->begin(),
                     acc.mvalues->end()));
         }
+        if (acc.msketch) {
+            msketch.reset(new QuantileSketch(*acc.msketch));
+        }
     }
 
     /**
@@ -237,12 +255,55 @@ public:
         } case ORDERED: {
             mvalues->push_back(v);
             break;
+        } case SKETCH: {
+            msum += v;
+            mcount++;
+            msketch->insert(v);
+            break;
         } default:
             throw vle::utils::ArgError(" [accu_mono] not yet implemented (1)");
             break;
         }
     }
 
+    /**
+     * @brief Merges the values of another accumulator into this one, as
+     * if the values inserted into @e acc were inserted into this one.
+     * For the ORDERED storage, values of @e acc are appended.
+     * @param acc, the accumulator to merge (with the same storage)
+     */
+    inline void merge(const AccuMono& acc)
+    {
+        if (acc.accu != accu) {
+            throw vle::utils::ArgError(" [accu_mono] merge of different"
+                    " storages");
+        }
+        switch (accu) {
+        case STANDARD: {
+            msum += acc.msum;
+            mcount += acc.mcount;
+            msquareSum += acc.msquareSum;
+            mmin = std::min(acc.mmin, mmin);
+            mmax = std::max(acc.mmax, mmax);
+            break;
+        } case MEAN: {
+            msum += acc.msum;
+            mcount += acc.mcount;
+            break;
+        } case QUANTILE:
+          case ORDERED: {
+            mvalues->insert(mvalues->end(), acc.mvalues->begin(),
+                    acc.mvalues->end());
+            msorted = false;
+            break;
+        } case SKETCH: {
+            msum += acc.msum;
+            mcount += acc.mcount;
+            msketch->merge(*acc.msketch);
+            break;
+        }}
+    }
+
     /**
      * @brief Mean statistic extractor
      * @return the mean value
@@ -251,7 +312,8 @@ public:
     {
         switch (accu) {
         case STANDARD:
-        case MEAN: {
+        case MEAN:
+        case SKETCH: {
             return msum / mcount;
             break;
         } case QUANTILE:
@@ -364,6 +426,7 @@ public:
             return msquareSum;
             break;
         case MEAN:
+        case SKETCH:
             throw vle::utils::ArgError(" [accu_mono] not available");
             break;
         case QUANTILE:
@@ -387,6 +450,7 @@ public:
         switch (accu) {
         case STANDARD:
         case MEAN:
+        case SKETCH:
             return mcount;
             break;
         case QUANTILE:
@@ -406,6 +470,7 @@ public:
         switch (accu) {
         case STANDARD:
         case MEAN:
+        case SKETCH:
             return msum;
             break;
         case QUANTILE:
@@ -425,6 +490,9 @@ public:
         case STANDARD:
             return mmin;
             break;
+        case SKETCH:
+            return msketch->min();
+            break;
         case MEAN:
             throw vle::utils::ArgError(" [accu_mono] not available");
             break;
@@ -448,6 +516,9 @@ public:
         case STANDARD:
             return mmax;
             break;
+        case SKETCH:
+            return msketch->max();
+            break;
         default:
             throw vle::utils::ArgError(" [accu_mono] not available");
             return 0;
@@ -466,6 +537,7 @@ public:
         case STANDARD:
         case MEAN:
         case QUANTILE:
+        case SKETCH:
             throw vle::utils::ArgError(" [accu_mono] not available");
             break;
         case ORDERED:
@@ -508,6 +580,9 @@ public:
             vals.insert(vals.begin(), mvalues->begin(),mvalues->end());
             return quantileOnSortedVect(vals, quantileOrder);
             break;
+        } case SKETCH: {
+            return msketch->quantile(quantileOrder);
+            break;
         }}
         return 0;
     }
@@ -575,6 +650,9 @@ public:
         mmax = std::numeric_limits<double>::min();
         msorted = false;
         mvalues.reset(nullptr);
+        if (msketch) {
+            msketch->clear();
+        }
     }
 
 protected:
@@ -603,6 +681,7 @@ protected:
     double mmax;
     bool msorted;//true if the vector of values is sorted
     std::unique_ptr<std::vector<double>> mvalues;
+    std::unique_ptr<QuantileSketch> msketch;
     double mquantile; //default value of quantile for stat 'quantile'
     unsigned int mat;//default value of index for stat 'at'
 };
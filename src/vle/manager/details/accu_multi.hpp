@@ -52,10 +52,10 @@ public:
         init_size(false), mstats()
     {
     }
-    AccuMulti(AccuStat s) : accu(),
+    AccuMulti(AccuStat s, bool sketch = false) : accu(),
         init_size(false), mstats()
     {
-        accu = AccuMono::storageTypeForStat(s);
+        accu = AccuMono::storageTypeForStat(s, sketch);
     }
 
     AccuMulti(const AccuMulti& acc) : accu(acc.accu),
@@ -115,7 +115,9 @@ public:
 
     void insertAccuStat(AccuMulti& a, AccuStat s)
     {
-        if (a.size() != size()) {
+        if (mstats.empty()) {
+            setSize(a.size());
+        } else if (a.size() != size()) {
             throw vle::utils::ArgError(" [accu_multi] error size ");
         }
         for (unsigned int i=0; i < a.size() ; i++) {
@@ -147,6 +149,48 @@ public:
         }
     }
 
+    /**
+     * @brief Inserts a column of reals (without name)
+     * @param values, the reals of the column
+     */
+    void insertColumn(const std::vector<double>& values)
+    {
+        if (not hasSize()) {
+            setSize(values.size());
+        } else {
+            if (values.size() != mstats.size()) {
+                throw vle::utils::ArgError(" [accu_multi] error size ");
+            }
+        }
+        for (unsigned int i=0; i < values.size() ; i++) {
+            mstats[i].insert(values[i]);
+        }
+    }
+
+    /**
+     * @brief Merges another multi dimensional accumulator into this one
+     * (see AccuMono::merge).
+     * @param acc, the accumulator to merge
+     */
+    void merge(const AccuMulti& acc)
+    {
+        if (acc.mstats.empty()) {
+            return;
+        }
+        if (mstats.empty()) {
+            for (const AccuMono& a : acc.mstats) {
+                mstats.emplace_back(a);
+            }
+            return;
+        }
+        if (acc.mstats.size() != mstats.size()) {
+            throw vle::utils::ArgError(" [accu_multi] error size ");
+        }
+        for (unsigned int i=0; i < mstats.size() ; i++) {
+            mstats[i].merge(acc.mstats[i]);
+        }
+    }
+
     /**
      * @brief generic get Stat
      * @param res[out], tuple filled with stat of all Accu
@@ -215,6 +259,9 @@ public:
      */
     inline unsigned int count()
     {
+        if (mstats.empty()) {
+            return 0;
+        }
         return mstats[0].count();
     }
 
@@ -3,13 +3,24 @@
 #ifndef VLE_MANAGER_DETAILS_CVLE_FILE_HANDLERS_HPP_
 #define VLE_MANAGER_DETAILS_CVLE_FILE_HANDLERS_HPP_
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <fstream>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 
 #include <vle/value/Set.hpp>
 #include <vle/value/Tuple.hpp>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace vle {
 namespace manager {
 
@@ -345,6 +356,271 @@ cvle_read(const utils::Path& tempOutCsv, unsigned int inputSize,
     return results;
 };
 
+
+/////////////// Binary output reader
+
+/**
+ * @brief Read only view of a file, mapped in memory when available. The
+ * data is aligned on 8 bytes.
+ */
+class cvle_mapped_file
+{
+public:
+    cvle_mapped_file(const std::string& path)
+      : mdata(nullptr), msize(0), mbuffer()
+    {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) == 0 and st.st_size > 0) {
+            void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE,
+                    fd, 0);
+            if (addr != MAP_FAILED) {
+                ::madvise(addr, st.st_size, MADV_SEQUENTIAL);
+                mdata = static_cast<const char*>(addr);
+                msize = st.st_size;
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        file.seekg(0, std::ios::end);
+        std::streamoff size = file.tellg();
+        if (size > 0) {
+            file.seekg(0, std::ios::beg);
+            mbuffer.resize((size + sizeof(double) - 1) / sizeof(double));
+            file.read(reinterpret_cast<char*>(mbuffer.data()), size);
+            mdata = reinterpret_cast<const char*>(mbuffer.data());
+            msize = size;
+        }
+#endif
+    }
+
+    ~cvle_mapped_file()
+    {
+#ifndef _WIN32
+        if (mdata) {
+            ::munmap(const_cast<char*>(mdata), msize);
+        }
+#endif
+    }
+
+    cvle_mapped_file(const cvle_mapped_file&) = delete;
+    cvle_mapped_file& operator=(const cvle_mapped_file&) = delete;
+
+    const char* data() const
+    {
+        return mdata;
+    }
+
+    std::size_t size() const
+    {
+        return msize;
+    }
+
+private:
+    const char* mdata;
+    std::size_t msize;
+    std::vector<double> mbuffer;
+};
+
+/**
+ * @brief Cursor on a record of the binary output of cvle (see the
+ * BinaryRecord class in apps/cvle/cvle.cpp for the format)
+ */
+class cvle_record_reader
+{
+public:
+    cvle_record_reader(const char* begin, std::size_t size)
+      : mbegin(begin), mpos(begin), mend(begin + size)
+    {}
+
+    std::uint32_t u32()
+    {
+        check(sizeof(std::uint32_t));
+        std::uint32_t value;
+        std::memcpy(&value, mpos, sizeof(value));
+        mpos += sizeof(value);
+        return value;
+    }
+
+    std::string str()
+    {
+        std::uint32_t size = u32();
+        check(size);
+        std::string value(mpos, size);
+        mpos += size;
+        return value;
+    }
+
+    void pad()
+    {
+        mpos += (8 - (mpos - mbegin) % 8) % 8;
+    }
+
+    //doubles are 8 bytes aligned: the record and the file mapping are
+    const double* doubles(std::size_t nb)
+    {
+        check(nb * sizeof(double));
+        const double* values = reinterpret_cast<const double*>(mpos);
+        mpos += nb * sizeof(double);
+        return values;
+    }
+
+private:
+    void check(std::size_t size) const
+    {
+        if (size > (std::size_t) (mend - mpos)) {
+            throw vu::ArgError("[Manager] truncated cvle binary output");
+        }
+    }
+
+    const char* mbegin;
+    const char* mpos;
+    const char* mend;
+};
+
+static const std::uint32_t cvle_binary_magic = 0x424c5643;
+
+/**
+ * @brief Read the binary output of cvle (option --binary-output). The
+ * file is mapped in memory and only the columns required by the outputs
+ * (and the time) are converted into the matrix given to
+ * ManOutput::insertReplicate.
+ */
+std::unique_ptr<value::Map>
+cvle_read_binary(const utils::Path& tempOut, unsigned int inputSize,
+        unsigned int repSize, std::vector<std::unique_ptr<ManOutput>>& outputs,
+        manager::Error& err)
+{
+    std::unique_ptr<value::Map> results = init_results(outputs, err);
+    if (err.code) {
+        return nullptr;
+    }
+    cvle_mapped_file file(tempOut.string());
+    std::vector <std::string> tokens;
+    std::vector <std::string> names;
+    std::vector <unsigned int> selected;
+    unsigned int nbSimus = 0;
+    std::size_t offset = 0;
+
+    try {
+        while (offset < file.size()) {
+            cvle_record_reader header(file.data() + offset,
+                    file.size() - offset);
+            if (header.u32() != cvle_binary_magic) {
+                throw vu::ArgError("[Manager] bad record in cvle binary"
+                        " output");
+            }
+            std::uint32_t recordSize = header.u32();
+            if (recordSize == 0 or recordSize % 8 != 0 or
+                    recordSize > file.size() - offset) {
+                throw vu::ArgError("[Manager] bad record size in cvle"
+                        " binary output");
+            }
+            cvle_record_reader record(file.data() + offset, recordSize);
+            record.u32();
+            record.u32();
+            std::uint32_t status = record.u32();
+            std::string id = record.str();
+
+            //split id_10_2
+            tokens.clear();
+            utils::tokenize(id, tokens, "_", false);
+            if (tokens.size() != 3 or tokens[0] != "id") {
+                throw vu::ArgError(utils::format("[Manager] bad simulation"
+                        " id '%s' in cvle binary output", id.c_str()));
+            }
+            int inputId = std::stoi(tokens[1]);
+            int inputRepl = std::stoi(tokens[2]);
+            if (status != 0) {
+                err.code = -1;
+                err.message = "[Manager] ";
+                err.message += vle::utils::format(
+                        "Error in simu id=%d, repl=%d ", inputId, inputRepl);
+                err.message += record.str();
+                return nullptr;
+            }
+
+            std::uint32_t nbViews = record.u32();
+            for (std::uint32_t v = 0; v < nbViews; v++) {
+                std::string viewName = record.str();
+                std::uint32_t nbCols = record.u32();
+                std::uint32_t nbRows = record.u32();
+                names.resize(nbCols);
+                for (std::uint32_t c = 0; c < nbCols; c++) {
+                    names[c] = record.str();
+                }
+                record.pad();
+                const double* values = record.doubles(
+                        (std::size_t) nbCols * nbRows);
+
+                //keep the time and the columns of the outputs
+                selected.clear();
+                for (std::uint32_t c = 0; c < nbCols; c++) {
+                    bool keep = (c == 0);
+                    for (unsigned int o=0; o < outputs.size() and not keep;
+                            o++) {
+                        keep = (outputs[o]->view == viewName and
+                                outputs[o]->absolutePort == names[c]);
+                    }
+                    if (keep) {
+                        selected.push_back(c);
+                    }
+                }
+                if (selected.size() < 2) {
+                    continue;
+                }
+                value::Matrix viewMatrix(selected.size(), nbRows + 1,
+                        selected.size(), 1);
+                for (unsigned int s = 0; s < selected.size(); s++) {
+                    std::uint32_t c = selected[s];
+                    viewMatrix.set(s, 0, value::String::create(names[c]));
+                    const double* column = values + (std::size_t) c * nbRows;
+                    for (std::uint32_t r = 0; r < nbRows; r++) {
+                        double val = column[r];
+                        if (c == 0 and std::isinf(val)) {
+                            val = std::numeric_limits<double>::max();
+                        }
+                        viewMatrix.set(s, r + 1, value::Double::create(val));
+                    }
+                }
+
+                //insert replicate for
+                std::unique_ptr<value::Value> aggrValue;
+                for (unsigned int o=0; o< outputs.size(); o++) {
+                    ManOutput& outId = *outputs[o];
+                    if (outId.view == viewName and std::find(names.begin(),
+                            names.end(), outId.absolutePort) != names.end()) {
+                        aggrValue = outId.insertReplicate(viewMatrix,
+                                inputId, inputSize, repSize);
+                        if (aggrValue) {
+                            results->set(outId.id, std::move(aggrValue));
+                        }
+                    }
+                }
+            }
+            offset += recordSize;
+            nbSimus ++;
+        }
+    } catch (const std::exception& e) {
+        err.code = -1;
+        err.message = e.what();
+        return nullptr;
+    }
+    if (nbSimus != inputSize*repSize) {
+        err.code = -1;
+        err.message = vle::utils::format("[Manager] cvle binary output "
+                "contains %u simulations, %u expected", nbSimus,
+                inputSize*repSize);
+        return nullptr;
+    }
+    return results;
+}
+
 }
 } // namespace vle manager
 
@@ -0,0 +1,385 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MANAGER_DETAILS_INTEGRATION_PLUGIN_HPP_
+#define VLE_MANAGER_DETAILS_INTEGRATION_PLUGIN_HPP_
+
+#include <vle/devs/Time.hpp>
+#include <vle/oov/Plugin.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Null.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Tuple.hpp>
+
+#include "manager/details/manager_concepts.hpp"
+
+#include <algorithm>
+#include <map>
+
+namespace vle {
+namespace manager {
+
+/**
+ * @brief Output plug-in installed by the manager on the views of the
+ * experiment plan outputs when none of them needs all the values
+ * (integration 'last', 'max', 'sum' or 'mse'). The observed values are
+ * integrated during the simulation, as DelegateOut::integrateReplicate
+ * does on the matrix of the storage plug-in, so the memory does not grow
+ * with the duration of the simulation.
+ *
+ * The result is a matrix of two rows: the identifiers of the outputs and
+ * the integrated values. A row is counted for each date as the storage
+ * plug-in does, and only the last value of a column in a row is kept, so
+ * the results are the ones computed from the storage matrix:
+ * - 'last' is the value of the last row, value::Null if the column has no
+ *   value in this row (the storage cell is empty).
+ * - 'max', 'sum' and 'mse' are value::Null if a row used by the
+ *   integration has no value or a value that is not a double, where the
+ *   matrix integration fails. DelegateOut::integrateReplicate then throws.
+ */
+class IntegrationPlugin : public oov::Plugin
+{
+public:
+    static const char* factoryName()
+    {
+        return "vle_manager_integration";
+    }
+
+    /**
+     * @brief Build the parameters of the plug-in for the outputs of a view
+     * @param outputs, the outputs of the view (integration different from
+     * 'all')
+     */
+    static std::unique_ptr<value::Value>
+    parameters(const std::vector<ManOutput*>& outputs)
+    {
+        std::unique_ptr<value::Set> res(new value::Set());
+        for (const ManOutput* o : outputs) {
+            value::Map& conf = res->addMap();
+            conf.addString("id", o->id);
+            conf.addString("port", o->absolutePort);
+            conf.addInt("integration", o->integrationType);
+            if (o->integrationType == MSE) {
+                conf.add("mse_times", o->mse_times->clone());
+                conf.add("mse_observations", o->mse_observations->clone());
+            }
+        }
+        return res;
+    }
+
+    IntegrationPlugin(const std::string& location)
+      : oov::Plugin(location), mcolumns(), mports(), mrow(0),
+        mtime(devs::negativeInfinity)
+    {}
+
+    ~IntegrationPlugin() override = default;
+
+    std::string name() const override
+    {
+        return factoryName();
+    }
+
+    void onParameter(const std::string& /*plugin*/,
+                     const std::string& /*location*/,
+                     const std::string& /*file*/,
+                     std::unique_ptr<value::Value> parameters,
+                     const double& /*time*/) override
+    {
+        if (not parameters or not parameters->isSet()) {
+            throw vu::ArgError("[Manager] integration plug-in expects a set"
+                    " of outputs");
+        }
+        const value::Set& outputs = parameters->toSet();
+        mcolumns.resize(outputs.size());
+        for (unsigned int i=0; i < outputs.size(); i++) {
+            const value::Map& conf = outputs.getMap(i);
+            Column& col = mcolumns[i];
+            col.id = conf.getString("id");
+            col.type = (INTEGRATION_TYPE) conf.getInt("integration");
+            col.value = (col.type == MAX) ? -9999 : 0;
+            if (col.type == MSE) {
+                const value::Tuple& times = conf.getTuple("mse_times");
+                const value::Tuple& obs = conf.getTuple("mse_observations");
+                for (unsigned int j=0; j < times.size(); j++) {
+                    int t = std::floor(times.at(j));
+                    if (t >= 0) {
+                        col.mse.emplace_back(t + 1, obs.at(j));
+                    }
+                }
+                std::stable_sort(col.mse.begin(), col.mse.end(),
+                        [](const std::pair<unsigned int, double>& a,
+                           const std::pair<unsigned int, double>& b) {
+                            return a.first < b.first;
+                        });
+            }
+            mports[conf.getString("port")].push_back(i);
+        }
+    }
+
+    void onNewObservable(const std::string& /*simulator*/,
+                         const std::string& /*parent*/,
+                         const std::string& /*port*/,
+                         const std::string& /*view*/,
+                         const double& /*time*/) override
+    {}
+
+    std::int32_t onNewObservableHandle(const std::string& simulator,
+                                       const std::string& parent,
+                                       const std::string& port,
+                                       const std::string& /*view*/,
+                                       const double& /*time*/) override
+    {
+        std::string key = parent;
+        key += ':';
+        key += simulator;
+        key += '.';
+        key += port;
+
+        auto it = mports.find(key);
+        mhandles.push_back(it == mports.end() ? nullptr : &it->second);
+
+        return static_cast<std::int32_t>(mhandles.size() - 1);
+    }
+
+    void onDelObservable(const std::string& /*simulator*/,
+                         const std::string& /*parent*/,
+                         const std::string& /*port*/,
+                         const std::string& /*view*/,
+                         const double& /*time*/) override
+    {}
+
+    void onValue(const std::string& simulator,
+                 const std::string& parent,
+                 const std::string& port,
+                 const std::string& /*view*/,
+                 const double& time,
+                 std::unique_ptr<value::Value> value) override
+    {
+        nextTime(time);
+        if (simulator.empty() or not value) {
+            return;
+        }
+        std::string key = parent;
+        key += ':';
+        key += simulator;
+        key += '.';
+        key += port;
+
+        auto it = mports.find(key);
+        if (it != mports.end()) {
+            integrate(it->second, std::move(value));
+        }
+    }
+
+    void onHandleValue(std::int32_t handle,
+                       const double& time,
+                       std::unique_ptr<value::Value> value) override
+    {
+        nextTime(time);
+        if (mhandles[handle] and value) {
+            integrate(*mhandles[handle], std::move(value));
+        }
+    }
+
+    void onHandleReal(std::int32_t handle,
+                      const double& time,
+                      double value) override
+    {
+        nextTime(time);
+        if (not mhandles[handle]) {
+            return;
+        }
+        for (unsigned int i : *mhandles[handle]) {
+            Column& col = mcolumns[i];
+            nextRow(col);
+            col.last.reset();
+            col.lastreal = value;
+            col.haslastreal = true;
+        }
+    }
+
+    std::unique_ptr<value::Matrix> finish(const double& /*time*/) override
+    {
+        std::unique_ptr<value::Matrix> res(new value::Matrix(
+                mcolumns.size(), mrow > 0 ? 2 : 1, 10, 10));
+        for (unsigned int i=0; i < mcolumns.size(); i++) {
+            Column& col = mcolumns[i];
+            res->set(i, 0, value::String::create(col.id));
+            if (mrow == 0) {
+                continue;
+            }
+            if (col.type == LAST) {
+                if (col.lastrow != mrow) {
+                    res->set(i, 1, value::Null::create());
+                } else if (col.haslastreal) {
+                    res->set(i, 1, value::Double::create(col.lastreal));
+                } else {
+                    res->set(i, 1, std::move(col.last));
+                }
+                continue;
+            }
+            if (col.lastrow > 0) {
+                integrate(col);
+            }
+            if (col.type == MSE) {
+                //observations of rows without value
+                while (col.next < col.mse.size() and
+                        col.mse[col.next].first <= mrow) {
+                    col.valid = false;
+                    col.next++;
+                }
+            } else if (col.rows != mrow) {
+                col.valid = false;
+            }
+            if (not col.valid) {
+                res->set(i, 1, value::Null::create());
+            } else if (col.type == MSE) {
+                res->set(i, 1, value::Double::create(col.value / col.nbVal));
+            } else {
+                res->set(i, 1, value::Double::create(col.value));
+            }
+        }
+        return res;
+    }
+
+private:
+    struct Column
+    {
+        std::string id;
+        INTEGRATION_TYPE type = LAST;
+        //last value of the row lastrow (a real if haslastreal)
+        std::unique_ptr<value::Value> last;
+        double lastreal = 0;
+        bool haslastreal = false;
+        unsigned int lastrow = 0;//0 if no value
+        double value = 0;//max, sum or sum of square errors
+        unsigned int rows = 0;//number of rows integrated (max and sum)
+        //for mse: rows of the observations (sorted)
+        std::vector<std::pair<unsigned int, double>> mse;
+        unsigned int next = 0;
+        double nbVal = 0;
+        bool valid = true;//false if a row has no double value
+    };
+
+    void nextTime(double time)
+    {
+        if (time != mtime) {
+            mtime = time;
+            mrow++;
+        }
+    }
+
+    void integrate(const std::vector<unsigned int>& cols,
+            std::unique_ptr<value::Value> value)
+    {
+        for (unsigned int i=0; i < cols.size(); i++) {
+            Column& col = mcolumns[cols[i]];
+            nextRow(col);
+            col.haslastreal = false;
+            if (i + 1 == cols.size()) {
+                col.last = std::move(value);
+                return;
+            }
+            col.last = value->clone();
+        }
+    }
+
+    /**
+     * @brief Before a value of a new row, integrates the last value of
+     * the previous row of the column
+     */
+    void nextRow(Column& col)
+    {
+        if (col.lastrow != mrow) {
+            if (col.lastrow > 0 and col.type != LAST) {
+                integrate(col);
+            }
+            col.lastrow = mrow;
+        }
+    }
+
+    /**
+     * @brief Integrates the last value of the row lastrow
+     */
+    void integrate(Column& col)
+    {
+        bool isdouble = true;
+        double v = 0;
+        if (col.haslastreal) {
+            v = col.lastreal;
+        } else if (col.last and col.last->isDouble()) {
+            v = col.last->toDouble().value();
+        } else {
+            isdouble = false;
+        }
+        switch (col.type) {
+        case MAX:
+        case SUM:
+            if (not isdouble) {
+                col.valid = false;
+            } else if (col.type == MAX) {
+                col.value = std::max(col.value, v);
+            } else {
+                col.value += v;
+            }
+            col.rows++;
+            break;
+        case MSE:
+            //observations of rows without value
+            while (col.next < col.mse.size() and
+                    col.mse[col.next].first < col.lastrow) {
+                col.valid = false;
+                col.next++;
+            }
+            while (col.next < col.mse.size() and
+                    col.mse[col.next].first == col.lastrow) {
+                if (not isdouble) {
+                    col.valid = false;
+                } else {
+                    col.value += std::pow(v - col.mse[col.next].second, 2);
+                    col.nbVal++;
+                }
+                col.next++;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    std::vector<Column> mcolumns;
+    std::map<std::string, std::vector<unsigned int>> mports;
+    //columns of the observables by handle (nullptr if not integrated)
+    std::vector<const std::vector<unsigned int>*> mhandles;
+    unsigned int mrow;//number of dates, as the rows of storage
+    double mtime;
+};
+
+}} // namespace vle manager
+
+#endif
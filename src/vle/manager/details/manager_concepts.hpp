@@ -1,8 +1,11 @@
 #ifndef VLE_MANAGER_DETAILS_MANAGER_CONCEPTS_HPP_
 #define VLE_MANAGER_DETAILS_MANAGER_CONCEPTS_HPP_
 
+#include <cmath>
 #include <vle/value/Boolean.hpp>
 #include <vle/value/Double.hpp>
+#include <vle/value/Null.hpp>
+#include <vle/value/Set.hpp>
 #include <vle/value/String.hpp>
 #include <vle/utils/Package.hpp>
 
@@ -149,6 +152,125 @@ struct ManReplicate
 };
 
 
+/**
+ * @brief The values of an output for one simulation: a column of the
+ * matrix of a view, after the header, or the value::Tuple (the reals) or
+ * the value::Set of the column of a view from the columnar storage
+ * plug-in (see the 'columnar' parameter of the storage plug-in), which is
+ * read without copy.
+ */
+class OutputColumn
+{
+public:
+    /**
+     * @param m, the matrix of the view, with a header
+     * @param col, the index of the column
+     * @param columnar, true if the matrix comes from the columnar storage
+     */
+    OutputColumn(value::Matrix& m, unsigned int col, bool columnar):
+        mmatrix(m), mcol(col), mreals(nullptr), mvalues(nullptr)
+    {
+        if (columnar) {
+            value::Value& v = *m.get(col, 1);
+            if (v.isTuple()) {
+                mreals = &v.toTuple().value();
+            } else {
+                mvalues = &v.toSet();
+            }
+        }
+    }
+
+    unsigned int size() const
+    {
+        if (mreals) {
+            return mreals->size();
+        }
+        if (mvalues) {
+            return mvalues->size();
+        }
+        return mmatrix.rows() - 1;
+    }
+
+    bool isDouble() const
+    {
+        if (mreals) {
+            return true;
+        }
+        if (mvalues) {
+            return mvalues->size() > 0 and mvalues->get(0)->isDouble();
+        }
+        return mmatrix.get(mcol, 1)->isDouble();
+    }
+
+    double getDouble(unsigned int i) const
+    {
+        if (mreals) {
+            return (*mreals)[i];
+        }
+        if (mvalues) {
+            return mvalues->getDouble(i);
+        }
+        return mmatrix.getDouble(mcol, i + 1);
+    }
+
+    std::unique_ptr<value::Value> clone(unsigned int i) const
+    {
+        if (mreals) {
+            return real((*mreals)[i]);
+        }
+        if (mvalues) {
+            return mvalues->get(i)->clone();
+        }
+        return mmatrix.get(mcol, i + 1)->clone();
+    }
+
+    std::unique_ptr<value::Value> give(unsigned int i)
+    {
+        if (mreals) {
+            return real((*mreals)[i]);
+        }
+        if (mvalues) {
+            return mvalues->give(i);
+        }
+        return mmatrix.give(mcol, i + 1);
+    }
+
+    /**
+     * @brief Inserts the reals of the column into an accumulator
+     */
+    void insertInto(AccuMulti& accu) const
+    {
+        if (mreals) {
+            accu.insertColumn(*mreals);
+        } else if (mvalues) {
+            std::vector<double> reals(mvalues->size());
+            for (unsigned int i=0; i < reals.size(); i++) {
+                reals[i] = mvalues->getDouble(i);
+            }
+            accu.insertColumn(reals);
+        } else {
+            accu.insertColumn(mmatrix, mcol);
+        }
+    }
+
+private:
+    /**
+     * @brief A NaN of the reals of the columnar storage is a missing value
+     */
+    static std::unique_ptr<value::Value> real(double v)
+    {
+        if (std::isnan(v)) {
+            return value::Null::create();
+        }
+        return value::Double::create(v);
+    }
+
+    value::Matrix& mmatrix;
+    unsigned int mcol;
+    std::vector<double>* mreals;
+    value::Set* mvalues;
+};
+
 class ManOutput;
 /**
  * Delegate output functionnalities
@@ -165,16 +287,27 @@ public:
 
 
     virtual std::unique_ptr<vle::value::Value>
-    insertReplicate(vle::value::Matrix& outMat, unsigned int currInput) = 0;
+    insertReplicate(OutputColumn& outCol, unsigned int currInput) = 0;
+
+    /**
+     * Merges the replicates inserted into another delegate of the same
+     * type (built for a copy of the same output) into this one. The other
+     * delegate is emptied.
+     * @param [in] the other delegate
+     * @return the input aggregated value if all inputs and all replicates
+     * have aggregated
+     */
+    virtual std::unique_ptr<vle::value::Value>
+    merge(DelegateOut& other) = 0;
 
     /**
      * Temporal integration, shared with other delegates
      * @param [in] the vle output
-     * @param [in] the output matrix
+     * @param [in] the output column
      * @return the temporal integration of the output
      */
     static std::unique_ptr<value::Value> integrateReplicate(ManOutput& vleout,
-            vle::value::Matrix& outMat);
+            OutputColumn& outCol);
 
     static AccuMulti& getAccu(std::map<int, std::unique_ptr<AccuMulti>>& accus,
             unsigned int index, const ManOutput& vleout);
@@ -198,7 +331,9 @@ public:
     DelOutStd(ManOutput& vleout);
 
     std::unique_ptr<vle::value::Value> insertReplicate(
-            vle::value::Matrix& outMat, unsigned int currInput) override;
+            OutputColumn& outCol, unsigned int currInput) override;
+
+    std::unique_ptr<vle::value::Value> merge(DelegateOut& other) override;
 
     //for replicate aggregation for current input index
     std::map<int, std::unique_ptr<AccuMono>> mreplicateAccu;
@@ -214,12 +349,16 @@ public:
     DelOutIntAggrALL(ManOutput& vleout, bool managedouble);
 
     std::unique_ptr<vle::value::Value> insertReplicate(
-            vle::value::Matrix& outMat, unsigned int currInput) override;
+            OutputColumn& outCol, unsigned int currInput) override;
+
+    std::unique_ptr<vle::value::Value> merge(DelegateOut& other) override;
 
     //for replicate aggregation for current input index
     std::map<int, std::unique_ptr<AccuMulti>> mreplicateAccu;
     std::unique_ptr<value::Value> minputAccu;
     unsigned int nbInputsFilled;
+    //inputs already set into minputAccu
+    std::vector<bool> mfilled;
 };
 
 /**
@@ -231,7 +370,9 @@ public:
     DelOutIntALL(ManOutput& vleout);
 
     std::unique_ptr<vle::value::Value> insertReplicate(
-            vle::value::Matrix& outMat, unsigned int currInput) override;
+            OutputColumn& outCol, unsigned int currInput) override;
+
+    std::unique_ptr<vle::value::Value> merge(DelegateOut& other) override;
 
     //for replicate aggregation for current input index
     std::map<int, std::unique_ptr<AccuMulti>> mreplicateAccu;
@@ -247,12 +388,16 @@ public:
     DelOutAggrALL(ManOutput& vleout, bool managedouble);
 
     std::unique_ptr<vle::value::Value> insertReplicate(
-            vle::value::Matrix& outMat, unsigned int currInput) override;
+            OutputColumn& outCol, unsigned int currInput) override;
+
+    std::unique_ptr<vle::value::Value> merge(DelegateOut& other) override;
 
     //for replicate aggregation for current input index
     std::map<int, std::unique_ptr<AccuMono>> mreplicateAccu;
     std::unique_ptr<value::Value> minputAccu;
     unsigned int nbInputsFilled;
+    //inputs already set into minputAccu
+    std::vector<bool> mfilled;
 };
 
 /**
@@ -308,6 +453,27 @@ public:
     insertReplicate(vle::value::Matrix& outMat, unsigned int currInput,
             unsigned int nbIn, unsigned int nbRepl);
 
+    /**
+     * @brief tells if a view comes from the columnar storage plug-in
+     * @param outMat, one view (matrix) from one simulation result
+     */
+    bool columnar(const vle::value::Matrix& outMat) const;
+
+    /**
+     * @brief merge the replicates inserted into another output
+     * (a clone of this one) into this output
+     * @param other, the other output, its delegate is emptied
+     * @return the input aggregated value if all inputs and all replicates
+     * have aggregated
+     */
+    std::unique_ptr<value::Value> merge(ManOutput& other);
+
+    /**
+     * @brief clone the configuration of the output (without the inserted
+     * replicates)
+     */
+    std::unique_ptr<ManOutput> clone() const;
+
     bool parsePath(const std::string& path);
 
     std::string id;
@@ -326,6 +492,10 @@ public:
     std::unique_ptr<vle::value::Tuple> mse_observations;
     //optionnal for aggregate_replicate = "quantile"
     double replicateAggregationQuantile;
+    //optionnal, quantiles are estimated with bounded memory
+    bool quantileSketch;
+    //values are integrated during the simulation (IntegrationPlugin)
+    bool integrated;
 };
 
 struct ManOutputSorter
@@ -715,13 +885,17 @@ ManReplicate::getName() const
 ////////// DelegateOut
 
 std::unique_ptr<value::Value>
-DelegateOut::integrateReplicate(ManOutput& vleout, vle::value::Matrix& outMat)
+DelegateOut::integrateReplicate(ManOutput& vleout, OutputColumn& outCol)
 {
+    if (vleout.integrated) {
+        //one column per output from the IntegrationPlugin
+        return outCol.give(0);
+    }
     switch(vleout.integrationType) {
     case MAX: {
         double max = -9999;
-        for (unsigned int i=1; i < outMat.rows(); i++) {
-            double v = outMat.getDouble(vleout.colIndex, i);
+        for (unsigned int i=0; i < outCol.size(); i++) {
+            double v = outCol.getDouble(i);
             if (v > max) {
                 max = v;
             }
@@ -730,18 +904,16 @@ DelegateOut::integrateReplicate(ManOutput& vleout, vle::value::Matrix& outMat)
         break;
     } case SUM: {
         double sum = 0;
-        for (unsigned int i=1; i < outMat.rows(); i++) {
-            sum += outMat.getDouble(vleout.colIndex, i);
+        for (unsigned int i=0; i < outCol.size(); i++) {
+            sum += outCol.getDouble(i);
         }
         return value::Double::create(sum);
         break;
     } case LAST: {
         if (vleout.shared) {
-            const std::unique_ptr<value::Value>& res =
-                    outMat.get(vleout.colIndex, outMat.rows() - 1);
-            return res->clone();
+            return outCol.clone(outCol.size() - 1);
         } else {
-            return std::move(outMat.give(vleout.colIndex, outMat.rows() - 1));
+            return outCol.give(outCol.size() - 1);
         }
         break;
     } case MSE: {
@@ -749,9 +921,9 @@ DelegateOut::integrateReplicate(ManOutput& vleout, vle::value::Matrix& outMat)
         double nbVal = 0;
         for (unsigned int i=0; i< vleout.mse_times->size(); i++) {
             int t = std::floor(vleout.mse_times->at(i));
-            if (t >= 0 and (t+1) < (int) outMat.rows()) {
+            if (t >= 0 and t < (int) outCol.size()) {
                 sum_square_error += std::pow(
-                        (outMat.getDouble(vleout.colIndex,t+1)
+                        (outCol.getDouble(t)
                                 - vleout.mse_observations->at(i)), 2);
                 nbVal++;
             }
@@ -775,7 +947,7 @@ DelegateOut::getAccu(std::map<int, std::unique_ptr<AccuMulti>>& accus,
         return *(itf->second);
     }
     std::unique_ptr<AccuMulti> ptr(new AccuMulti(
-            vleout.replicateAggregationType));
+            vleout.replicateAggregationType, vleout.quantileSketch));
     AccuMulti& ref = *ptr;
     ref.setDefaultQuantile(vleout.replicateAggregationQuantile);
     accus.insert(std::make_pair(index, std::move(ptr)));
@@ -792,7 +964,7 @@ DelegateOut::getAccu(std::map<int, std::unique_ptr<AccuMono>>& accu,
         return *(itf->second);
     }
     std::unique_ptr<AccuMono> ptr(new AccuMono(
-            vleout.replicateAggregationType));
+            vleout.replicateAggregationType, vleout.quantileSketch));
     AccuMono& ref = *ptr;
     ref.setDefaultQuantile(vleout.replicateAggregationQuantile);
     accu.insert(std::make_pair(index, std::move(ptr)));
@@ -801,16 +973,17 @@ DelegateOut::getAccu(std::map<int, std::unique_ptr<AccuMono>>& accu,
 
 DelOutStd::DelOutStd(ManOutput& vleout) : DelegateOut(vleout, true)
 {
-    minputAccu.reset(new AccuMono(vleOut.inputAggregationType));
+    minputAccu.reset(new AccuMono(vleOut.inputAggregationType,
+            vleOut.quantileSketch));
 }
 
 
 std::unique_ptr<vle::value::Value>
-DelOutStd::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput)
+DelOutStd::insertReplicate(OutputColumn& outCol, unsigned int currInput)
 {
     //start insertion for double management only
     std::unique_ptr<value::Value> intVal = std::move(
-            integrateReplicate(vleOut, outMat));
+            integrateReplicate(vleOut, outCol));
     if (vleOut.nbReplicates == 1) {
         minputAccu->insert(intVal->toDouble().value());
     } else {
@@ -834,57 +1007,86 @@ DelOutStd::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput)
     return nullptr;
 }
 
+std::unique_ptr<vle::value::Value>
+DelOutStd::merge(DelegateOut& other)
+{
+    DelOutStd& o = static_cast<DelOutStd&>(other);
+    if (not minputAccu or not o.minputAccu) {
+        return nullptr;
+    }
+    for (auto& r : o.mreplicateAccu) {
+        AccuMono& accuRepl = DelegateOut::getAccu(mreplicateAccu, r.first,
+                vleOut);
+        accuRepl.merge(*r.second);
+        if (accuRepl.count() == vleOut.nbReplicates) {
+            minputAccu->insert(accuRepl.getStat(
+                    vleOut.replicateAggregationType));
+            mreplicateAccu.erase(r.first);
+        }
+    }
+    o.mreplicateAccu.clear();
+    minputAccu->merge(*o.minputAccu);
+    o.minputAccu.reset(nullptr);
+    if (minputAccu->count() == vleOut.nbInputs) {
+        double res = minputAccu->getStat(vleOut.inputAggregationType);
+        minputAccu.reset(nullptr);
+        return value::Double::create(res);
+    }
+    return nullptr;
+}
+
 DelOutIntAggrALL::DelOutIntAggrALL(ManOutput& vleout, bool managedouble):
         DelegateOut(vleout, managedouble), mreplicateAccu(),
-        minputAccu(nullptr), nbInputsFilled(0)
+        minputAccu(nullptr), nbInputsFilled(0), mfilled(vleout.nbInputs, false)
 {
 }
 
 std::unique_ptr<vle::value::Value>
-DelOutIntAggrALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput)
+DelOutIntAggrALL::insertReplicate(OutputColumn& outCol,
+        unsigned int currInput)
 {
     if (not minputAccu) {
         if (manageDouble) {
             minputAccu.reset(new value::Table(vleOut.nbInputs,
-                    outMat.rows()-1));
+                    outCol.size()));
         } else {
             minputAccu.reset(new value::Matrix(vleOut.nbInputs,
-                    outMat.rows()-1, 10, 10));
+                    outCol.size(), 10, 10));
         }
     }
     //resize if necessary
     if (manageDouble) {
-        if (minputAccu->toTable().height() < outMat.rows()) {
-            minputAccu->toTable().resize(vleOut.nbInputs, outMat.rows()-1);
+        if (minputAccu->toTable().height() < outCol.size()) {
+            minputAccu->toTable().resize(vleOut.nbInputs, outCol.size());
         }
     } else {
-        if (minputAccu->toMatrix().rows() < outMat.rows()) {
-            minputAccu->toMatrix().resize(vleOut.nbInputs, outMat.rows()-1);
+        if (minputAccu->toMatrix().rows() < outCol.size()) {
+            minputAccu->toMatrix().resize(vleOut.nbInputs, outCol.size());
         }
     }
     //insert
     if (vleOut.nbReplicates == 1){//one can put directly into results
-        for (unsigned int i=1; i < outMat.rows(); i++) {
+        for (unsigned int i=0; i < outCol.size(); i++) {
             if (manageDouble) {
-                minputAccu->toTable().get(currInput, i-1) =
-                        outMat.getDouble(vleOut.colIndex, i);
+                minputAccu->toTable().get(currInput, i) =
+                        outCol.getDouble(i);
             } else if (vleOut.shared) {
-                minputAccu->toMatrix().set(currInput, i-1,
-                        outMat.get(vleOut.colIndex, i)->clone());
+                minputAccu->toMatrix().set(currInput, i, outCol.clone(i));
             } else {
-                minputAccu->toMatrix().set(currInput, i-1,
-                        std::move(outMat.give(vleOut.colIndex, i)));
+                minputAccu->toMatrix().set(currInput, i, outCol.give(i));
             }
         }
+        mfilled[currInput] = true;
         nbInputsFilled++;
     } else {
         AccuMulti& accuRepl = DelegateOut::getAccu(mreplicateAccu, currInput,
                 vleOut);
-        accuRepl.insertColumn(outMat, vleOut.colIndex);
+        outCol.insertInto(accuRepl);
         if (accuRepl.count() == vleOut.nbReplicates) {
             accuRepl.fillStat(minputAccu->toTable(),
                     currInput, vleOut.replicateAggregationType);
             mreplicateAccu.erase(currInput);
+            mfilled[currInput] = true;
             nbInputsFilled++;
         }
     }
@@ -894,23 +1096,82 @@ DelOutIntAggrALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currI
     return nullptr;
 }
 
+std::unique_ptr<vle::value::Value>
+DelOutIntAggrALL::merge(DelegateOut& other)
+{
+    DelOutIntAggrALL& o = static_cast<DelOutIntAggrALL&>(other);
+    if (not minputAccu or not o.minputAccu) {
+        return nullptr;
+    }
+    //resize if necessary
+    if (manageDouble) {
+        value::Table& dst = minputAccu->toTable();
+        if (dst.height() < o.minputAccu->toTable().height()) {
+            dst.resize(vleOut.nbInputs, o.minputAccu->toTable().height());
+        }
+    } else {
+        value::Matrix& dst = minputAccu->toMatrix();
+        if (dst.rows() < o.minputAccu->toMatrix().rows()) {
+            dst.resize(vleOut.nbInputs, o.minputAccu->toMatrix().rows());
+        }
+    }
+    //copy the inputs filled by the other delegate
+    for (unsigned int in=0; in < o.mfilled.size(); in++) {
+        if (not o.mfilled[in]) {
+            continue;
+        }
+        if (manageDouble) {
+            value::Table& src = o.minputAccu->toTable();
+            for (unsigned int i=0; i < src.height(); i++) {
+                minputAccu->toTable().get(in, i) = src.get(in, i);
+            }
+        } else {
+            value::Matrix& src = o.minputAccu->toMatrix();
+            for (unsigned int i=0; i < src.rows(); i++) {
+                minputAccu->toMatrix().set(in, i, std::move(src.give(in, i)));
+            }
+        }
+        mfilled[in] = true;
+        nbInputsFilled++;
+    }
+    for (auto& r : o.mreplicateAccu) {
+        AccuMulti& accuRepl = DelegateOut::getAccu(mreplicateAccu, r.first,
+                vleOut);
+        accuRepl.merge(*r.second);
+        if (accuRepl.count() == vleOut.nbReplicates) {
+            accuRepl.fillStat(minputAccu->toTable(),
+                    r.first, vleOut.replicateAggregationType);
+            mreplicateAccu.erase(r.first);
+            mfilled[r.first] = true;
+            nbInputsFilled++;
+        }
+    }
+    o.mreplicateAccu.clear();
+    o.minputAccu.reset(nullptr);
+    if (nbInputsFilled == vleOut.nbInputs) {
+        return std::move(minputAccu);
+    }
+    return nullptr;
+}
+
 DelOutIntALL::DelOutIntALL(ManOutput& vleout): DelegateOut(vleout, true),
     mreplicateAccu(), minputAccu(nullptr)
 {
 }
 
 std::unique_ptr<vle::value::Value>
-DelOutIntALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput)
+DelOutIntALL::insertReplicate(OutputColumn& outCol, unsigned int currInput)
 {
     if (not minputAccu) {
-        minputAccu.reset(new AccuMulti(vleOut.inputAggregationType));
+        minputAccu.reset(new AccuMulti(vleOut.inputAggregationType,
+                vleOut.quantileSketch));
     }
     if (vleOut.nbReplicates == 1){//one can put directly into results
-        minputAccu->insertColumn(outMat, vleOut.colIndex);
+        outCol.insertInto(*minputAccu);
     } else {
         AccuMulti& accuRepl = DelegateOut::getAccu(mreplicateAccu, currInput,
                 vleOut);
-        accuRepl.insertColumn(outMat, vleOut.colIndex);
+        outCol.insertInto(accuRepl);
         if (accuRepl.count() == vleOut.nbReplicates) {
             minputAccu->insertAccuStat(accuRepl,
                     vleOut.replicateAggregationType);
@@ -926,9 +1187,38 @@ DelOutIntALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput
     return nullptr;
 }
 
+std::unique_ptr<vle::value::Value>
+DelOutIntALL::merge(DelegateOut& other)
+{
+    DelOutIntALL& o = static_cast<DelOutIntALL&>(other);
+    if (not minputAccu or not o.minputAccu) {
+        return nullptr;
+    }
+    for (auto& r : o.mreplicateAccu) {
+        AccuMulti& accuRepl = DelegateOut::getAccu(mreplicateAccu, r.first,
+                vleOut);
+        accuRepl.merge(*r.second);
+        if (accuRepl.count() == vleOut.nbReplicates) {
+            minputAccu->insertAccuStat(accuRepl,
+                    vleOut.replicateAggregationType);
+            mreplicateAccu.erase(r.first);
+        }
+    }
+    o.mreplicateAccu.clear();
+    minputAccu->merge(*o.minputAccu);
+    o.minputAccu.reset(nullptr);
+    if (minputAccu->count() == vleOut.nbInputs) {
+        std::unique_ptr<value::Table> res(new value::Table(1,
+                minputAccu->size()));
+        minputAccu->fillStat(*res, 0, vleOut.inputAggregationType);
+        return res;
+    }
+    return nullptr;
+}
+
 DelOutAggrALL::DelOutAggrALL(ManOutput& vleout, bool managedouble):
         DelegateOut(vleout, managedouble), mreplicateAccu(),
-        minputAccu(nullptr), nbInputsFilled(0)
+        minputAccu(nullptr), nbInputsFilled(0), mfilled(vleout.nbInputs, false)
 {
     if (manageDouble) {
         minputAccu.reset(new value::Table(vleOut.nbInputs,1));
@@ -938,10 +1228,10 @@ DelOutAggrALL::DelOutAggrALL(ManOutput& vleout, bool managedouble):
 }
 
 std::unique_ptr<vle::value::Value>
-DelOutAggrALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput)
+DelOutAggrALL::insertReplicate(OutputColumn& outCol, unsigned int currInput)
 {
     std::unique_ptr<value::Value> intVal = std::move(
-            integrateReplicate(vleOut, outMat));
+            integrateReplicate(vleOut, outCol));
 
     if (vleOut.nbReplicates == 1){//one can put directly into results
         if (manageDouble) {
@@ -951,7 +1241,7 @@ DelOutAggrALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInpu
             minputAccu->toMatrix().set(currInput, 0, std::move(intVal));
 
         }
-
+        mfilled[currInput] = true;
         nbInputsFilled++;
     } else {
         AccuMono& accuRepl = DelegateOut::getAccu(mreplicateAccu, currInput,
@@ -961,9 +1251,52 @@ DelOutAggrALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInpu
             minputAccu->toTable().get(currInput, 0)=
                     accuRepl.getStat(vleOut.replicateAggregationType);
             mreplicateAccu.erase(currInput);
+            mfilled[currInput] = true;
+            nbInputsFilled++;
+        }
+    }
+    if (nbInputsFilled == vleOut.nbInputs) {
+        return std::move(minputAccu);
+    }
+    return nullptr;
+}
+
+std::unique_ptr<vle::value::Value>
+DelOutAggrALL::merge(DelegateOut& other)
+{
+    DelOutAggrALL& o = static_cast<DelOutAggrALL&>(other);
+    if (not minputAccu or not o.minputAccu) {
+        return nullptr;
+    }
+    //copy the inputs filled by the other delegate
+    for (unsigned int in=0; in < o.mfilled.size(); in++) {
+        if (not o.mfilled[in]) {
+            continue;
+        }
+        if (manageDouble) {
+            minputAccu->toTable().get(in, 0) =
+                    o.minputAccu->toTable().get(in, 0);
+        } else {
+            minputAccu->toMatrix().set(in, 0,
+                    std::move(o.minputAccu->toMatrix().give(in, 0)));
+        }
+        mfilled[in] = true;
+        nbInputsFilled++;
+    }
+    for (auto& r : o.mreplicateAccu) {
+        AccuMono& accuRepl = DelegateOut::getAccu(mreplicateAccu, r.first,
+                vleOut);
+        accuRepl.merge(*r.second);
+        if (accuRepl.count() == vleOut.nbReplicates) {
+            minputAccu->toTable().get(r.first, 0)=
+                    accuRepl.getStat(vleOut.replicateAggregationType);
+            mreplicateAccu.erase(r.first);
+            mfilled[r.first] = true;
             nbInputsFilled++;
         }
     }
+    o.mreplicateAccu.clear();
+    o.minputAccu.reset(nullptr);
     if (nbInputsFilled == vleOut.nbInputs) {
         return std::move(minputAccu);
     }
@@ -975,7 +1308,8 @@ ManOutput::ManOutput() : id(), view(), absolutePort(), colIndex(-1),
         shared(true), integrationType(LAST), replicateAggregationType(S_mean),
         inputAggregationType(S_at), nbInputs(0), nbReplicates(0),
         delegate(nullptr), mse_times(nullptr), mse_observations(nullptr),
-        replicateAggregationQuantile(0.5)
+        replicateAggregationQuantile(0.5), quantileSketch(false),
+        integrated(false)
 {
 }
 
@@ -984,7 +1318,8 @@ ManOutput::ManOutput(const std::string& _id, const vle::value::Value& val) :
         integrationType(LAST), replicateAggregationType(S_mean),
         inputAggregationType(S_at), nbInputs(0), nbReplicates(0),
         delegate(nullptr), mse_times(nullptr), mse_observations(nullptr),
-        replicateAggregationQuantile(0.5)
+        replicateAggregationQuantile(0.5), quantileSketch(false),
+        integrated(false)
 {
     std::string tmp;
     if (val.isString()) {
@@ -1021,6 +1356,9 @@ ManOutput::ManOutput(const std::string& _id, const vle::value::Value& val) :
                 error = true;
             }
         }
+        if (m.exist("quantile_sketch")) {
+            quantileSketch = m.getBoolean("quantile_sketch");
+        }
         if (m.exist("aggregation_input")) {
             tmp = m.getString("aggregation_input");
             if (tmp == "mean") {
@@ -1153,8 +1491,9 @@ ManOutput::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput,
         }
         //get col index
         colIndex = 9999;
+        const std::string& column = integrated ? id : absolutePort;
         for (unsigned int i=0; i < outMat.columns(); i++) {
-            if (outMat.getString(i,0) == absolutePort) {
+            if (outMat.getString(i,0) == column) {
                 colIndex = i;
             }
         }
@@ -1163,8 +1502,20 @@ ManOutput::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput,
                     "[Manager] view.port '%s' not found)",
                     absolutePort.c_str()));
         }
+    }
+    if (integrated and integrationType != LAST) {
+        //the IntegrationPlugin gives Null where the matrix integration
+        //fails: a row without value or with a value that is not a double
+        const std::unique_ptr<value::Value>& v = outMat.get(colIndex, 1);
+        if (not v or not v->isDouble()) {
+            throw vu::ArgError(utils::format(
+                    "[Manager] missing or not double value to integrate "
+                    "for output '%s'", id.c_str()));
+        }
+    }
+    if (not delegate) {
         bool manageDouble = true;
-        if (not outMat.get(colIndex,1)->isDouble()) {
+        if (not OutputColumn(outMat, colIndex, columnar(outMat)).isDouble()) {
             if (nbReplicates != 1 or
                     (integrationType != ALL  and integrationType != LAST) or
                     (inputAggregationType != S_at)){
@@ -1189,7 +1540,59 @@ ManOutput::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput,
             }
         }
     }
-    return delegate->insertReplicate(outMat, currInput);
+    OutputColumn outCol(outMat, colIndex, columnar(outMat));
+    if (outCol.size() == 0) {
+        throw vu::ArgError(utils::format(
+                "[Manager] no value for output '%s'", id.c_str()));
+    }
+    return delegate->insertReplicate(outCol, currInput);
+}
+
+bool
+ManOutput::columnar(const vle::value::Matrix& outMat) const
+{
+    //the dates of the columnar storage are a tuple
+    const std::unique_ptr<value::Value>& times = outMat.get(0, 1);
+    return not integrated and times and times->isTuple();
+}
+
+std::unique_ptr<value::Value>
+ManOutput::merge(ManOutput& other)
+{
+    if (not other.delegate) {
+        return nullptr;
+    }
+    if (not delegate) {
+        throw vu::InternalError(utils::format(
+                "[Manager] merge into the empty output '%s'", id.c_str()));
+    }
+    return delegate->merge(*other.delegate);
+}
+
+std::unique_ptr<ManOutput>
+ManOutput::clone() const
+{
+    std::unique_ptr<ManOutput> res(new ManOutput());
+    res->id = id;
+    res->view = view;
+    res->absolutePort = absolutePort;
+    res->colIndex = colIndex;
+    res->shared = shared;
+    res->integrationType = integrationType;
+    res->replicateAggregationType = replicateAggregationType;
+    res->inputAggregationType = inputAggregationType;
+    res->nbInputs = nbInputs;
+    res->nbReplicates = nbReplicates;
+    if (mse_times) {
+        res->mse_times.reset(new value::Tuple(*mse_times));
+    }
+    if (mse_observations) {
+        res->mse_observations.reset(new value::Tuple(*mse_observations));
+    }
+    res->replicateAggregationQuantile = replicateAggregationQuantile;
+    res->quantileSketch = quantileSketch;
+    res->integrated = integrated;
+    return res;
 }
 
 bool
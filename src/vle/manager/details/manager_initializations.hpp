@@ -6,6 +6,7 @@
 #include <vle/vpz/AtomicModel.hpp>
 
 #include "manager/details/vle_api_utils.hpp"
+#include "manager/details/integration_plugin.hpp"
 
 namespace vle {
 namespace manager {
@@ -105,7 +106,9 @@ post_propagates(vpz::Vpz& model,
 void
 config_views(vpz::Vpz& model,
              const std::vector<std::unique_ptr<ManOutput>>& outputs,
-             manager::Error& err)
+             manager::Error& err,
+             bool integrate = false,
+             bool columnar = false)
 {
     {//remove useless views, observables and observables ports.
         vle::vpz::BaseModel* baseModel = model.project().model().node();
@@ -130,12 +133,29 @@ config_views(vpz::Vpz& model,
         }
         VleAPIutils::keepOnly(model, viewsToKeep, obsAndPortTokeep);
     }
-    std::vector<std::unique_ptr<ManOutput>>::const_iterator itb =
-            outputs.begin();
-    std::vector<std::unique_ptr<ManOutput>>::const_iterator ite =
-            outputs.end();
-    for (; itb != ite; itb++) {
-        VleAPIutils::changePlugin(model, (*itb)->view, "storage");
+    //if possible, outputs of a view are integrated during the simulation
+    //(IntegrationPlugin), otherwise all values are stored (by columns if
+    //columnar, when the results are read by this process)
+    std::map<std::string, std::vector<ManOutput*>> views;
+    for (auto& o : outputs) {
+        views[o->view].push_back(o.get());
+    }
+    for (auto& v : views) {
+        bool integrated = integrate and
+                VleAPIutils::isTimedOrFinish(model, v.first);
+        for (ManOutput* o : v.second) {
+            integrated = integrated and o->integrationType != ALL;
+        }
+        for (ManOutput* o : v.second) {
+            o->integrated = integrated;
+        }
+        if (integrated) {
+            VleAPIutils::changePlugin(model, v.first,
+                    IntegrationPlugin::factoryName(),
+                    IntegrationPlugin::parameters(v.second));
+        } else {
+            VleAPIutils::changePlugin(model, v.first, "storage", columnar);
+        }
     }
 }
 
@@ -144,9 +164,10 @@ config_views(vpz::Vpz& model,
 void
 init_embedded_model(
         vpz::Vpz& model, const ManagerObjects& manObj,
-        const wrapper_init& init, manager::Error& err)
+        const wrapper_init& init, manager::Error& err,
+        bool integrate = false, bool columnar = false)
 {
-    config_views(model, manObj.mOutputs, err);
+    config_views(model, manObj.mOutputs, err, integrate, columnar);
     if (err.code) return ;
     post_define(model, manObj.mDefine, err);
     if (err.code) return ;
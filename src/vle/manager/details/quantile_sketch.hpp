@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2015-2015 INRA
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MANAGER_QUANTILE_SKETCH_HPP_
+#define VLE_MANAGER_QUANTILE_SKETCH_HPP_
+
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace vle {
+namespace manager {
+
+/**
+ * @brief Bounded memory and mergeable estimation of quantiles (merging
+ * t-digest, see Dunning and Ertl, "Computing extremely accurate quantiles
+ * using t-digests").
+ *
+ * Values are summarized into at most about compression/2 centroids (mean
+ * and weight), with a buffer of 5*compression values not yet merged. The
+ * scale function k(q) = compression/(2*pi)*asin(2q-1) keeps the centroids
+ * small near the tails. The error on the rank of the estimated quantile
+ * of order q is bounded by about pi*sqrt(q(1-q))/compression of the count:
+ * 0.8% at the median and less in the tails with the default compression
+ * of 200. Minimum and maximum are exact.
+ */
+class QuantileSketch
+{
+public:
+    struct Centroid
+    {
+        double mean;
+        double weight;
+
+        bool operator<(const Centroid& c) const
+        {
+            return mean < c.mean;
+        }
+    };
+
+    /**
+     * @brief sketch constructor
+     * @param compression, the accuracy parameter: memory is in
+     * O(compression) and the rank error in O(1/compression)
+     */
+    QuantileSketch(double compression = 200) :
+        mcompression(compression), mcount(0),
+        mmin(std::numeric_limits<double>::max()),
+        mmax(std::numeric_limits<double>::lowest()),
+        mcentroids(), mbuffer()
+    {
+        mbuffer.reserve(bufferSize());
+    }
+
+    /**
+     * @brief Inserts a real into the sketch
+     * @param v the real value
+     */
+    inline void insert(double v)
+    {
+        mbuffer.push_back(Centroid{v, 1});
+        mcount++;
+        mmin = std::min(v, mmin);
+        mmax = std::max(v, mmax);
+        if (mbuffer.size() >= bufferSize()) {
+            compress();
+        }
+    }
+
+    /**
+     * @brief Merges another sketch into this one
+     * @param s, the sketch to merge
+     */
+    inline void merge(const QuantileSketch& s)
+    {
+        mbuffer.insert(mbuffer.end(), s.mcentroids.begin(),
+                s.mcentroids.end());
+        mbuffer.insert(mbuffer.end(), s.mbuffer.begin(), s.mbuffer.end());
+        mcount += s.mcount;
+        mmin = std::min(s.mmin, mmin);
+        mmax = std::max(s.mmax, mmax);
+        compress();
+    }
+
+    /**
+     * @brief Merges the values of the buffer into the centroids
+     */
+    void compress()
+    {
+        if (mbuffer.empty()) {
+            return;
+        }
+        mbuffer.insert(mbuffer.end(), mcentroids.begin(), mcentroids.end());
+        std::sort(mbuffer.begin(), mbuffer.end());
+        mcentroids.clear();
+
+        double total = 0;
+        for (const Centroid& c : mbuffer) {
+            total += c.weight;
+        }
+        double weightSoFar = 0;
+        double kLeft = scale(0);
+        Centroid current = mbuffer[0];
+        for (unsigned int i=1; i < mbuffer.size(); i++) {
+            const Centroid& c = mbuffer[i];
+            double q = (weightSoFar + current.weight + c.weight) / total;
+            if (scale(q) - kLeft <= 1) {
+                current.weight += c.weight;
+                current.mean += (c.mean - current.mean) * c.weight /
+                        current.weight;
+            } else {
+                weightSoFar += current.weight;
+                mcentroids.push_back(current);
+                kLeft = scale(weightSoFar / total);
+                current = c;
+            }
+        }
+        mcentroids.push_back(current);
+        mbuffer.clear();
+    }
+
+    /**
+     * @brief Quantile value estimation, the values are linearly
+     * interpolated between the centers of the centroids
+     * @param p the quantile order
+     * @returns the estimated quantile value of order p
+     */
+    double quantile(double p)
+    {
+        compress();
+        if (mcentroids.empty()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        if (mcentroids.size() == 1 or p <= 0) {
+            return p <= 0 ? mmin : mcentroids[0].mean;
+        }
+        if (p >= 1) {
+            return mmax;
+        }
+        double index = p * mcount;
+        double left = 0;
+        double leftValue = mmin;
+        double center = 0;
+        for (const Centroid& c : mcentroids) {
+            double right = center + c.weight / 2;
+            if (index < right) {
+                return interpolate(index, left, leftValue, right, c.mean);
+            }
+            center += c.weight;
+            left = right;
+            leftValue = c.mean;
+        }
+        return interpolate(index, left, leftValue, mcount, mmax);
+    }
+
+    inline unsigned int count() const
+    {
+        return mcount;
+    }
+
+    inline double min() const
+    {
+        return mmin;
+    }
+
+    inline double max() const
+    {
+        return mmax;
+    }
+
+    /**
+     * @brief number of centroids (after compression)
+     */
+    inline unsigned int size()
+    {
+        compress();
+        return mcentroids.size();
+    }
+
+    void clear()
+    {
+        mcount = 0;
+        mmin = std::numeric_limits<double>::max();
+        mmax = std::numeric_limits<double>::lowest();
+        mcentroids.clear();
+        mbuffer.clear();
+    }
+
+protected:
+    inline unsigned int bufferSize() const
+    {
+        return 5 * mcompression;
+    }
+
+    inline double scale(double q) const
+    {
+        q = std::min(std::max(q, 0.0), 1.0);
+        return mcompression / (2 * M_PI) * asin(2 * q - 1);
+    }
+
+    static double interpolate(double x, double x0, double y0, double x1,
+            double y1)
+    {
+        if (x1 <= x0) {
+            return y1;
+        }
+        return y0 + (x - x0) * (y1 - y0) / (x1 - x0);
+    }
+
+    double mcompression;
+    unsigned int mcount;
+    double mmin;
+    double mmax;
+    std::vector<Centroid> mcentroids;//sorted by mean
+    std::vector<Centroid> mbuffer;//values not yet merged
+};
+
+}} //namespaces
+
+#endif
@@ -0,0 +1,506 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MANAGER_DETAILS_SIMULATION_SERVER_HPP_
+#define VLE_MANAGER_DETAILS_SIMULATION_SERVER_HPP_
+
+#include <vle/manager/Types.hpp>
+#include <vle/utils/Spawn.hpp>
+#include <vle/utils/Tools.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+#include "devs/ModelFactory.hpp"
+#include "devs/RootCoordinator.hpp"
+#include "utils/ContextPrivate.hpp"
+#include "utils/i18n.hpp"
+
+#include <boost/format.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace vle {
+namespace manager {
+
+#ifndef _WIN32
+
+/*
+ * The simulation server of the SIMULATION_SPAWN_PROCESS mode is a @e vle
+ * process started once by each @c Simulation with the @e
+ * vle.command.vle.server setting. The server keeps the context (settings,
+ * packages) and the shared libraries loaded by the previous simulations
+ * and forks a child for each simulation to isolate it.
+ *
+ * Messages on the socket:
+ * - ready: one byte 'S' written by the server when it starts to serve.
+ * - request: u32 size, i64 timeout (ms, 0 no timeout), size bytes of the
+ *   vpz.
+ * - reply: u32 size, size bytes with 'R' and the results (see
+ *   value::writeBinary) or 'E' and an error message.
+ */
+
+inline bool
+server_write(int fd, const void* buffer, std::size_t size)
+{
+    auto* ptr = static_cast<const char*>(buffer);
+
+    while (size) {
+        ssize_t ret = ::send(fd, ptr, size, MSG_NOSIGNAL);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        ptr += ret;
+        size -= static_cast<std::size_t>(ret);
+    }
+
+    return true;
+}
+
+inline bool
+server_read(int fd, void* buffer, std::size_t size)
+{
+    auto* ptr = static_cast<char*>(buffer);
+
+    while (size) {
+        ssize_t ret = ::read(fd, ptr, size);
+        if (ret <= 0) {
+            if (ret < 0 and errno == EINTR)
+                continue;
+            return false;
+        }
+
+        ptr += ret;
+        size -= static_cast<std::size_t>(ret);
+    }
+
+    return true;
+}
+
+inline bool
+server_reply(int fd, char type, const std::string& message)
+{
+    std::uint32_t size = static_cast<std::uint32_t>(message.size() + 1);
+
+    return server_write(fd, &size, sizeof(size)) and
+           server_write(fd, &type, 1) and
+           server_write(fd, message.data(), message.size());
+}
+
+/**
+ * Load the shared libraries of the dynamics and outputs of the @e vpz into
+ * the server. The forked children find them already loaded. Errors are
+ * reported by the simulation itself.
+ */
+inline void
+server_preload(utils::ContextPtr context,
+               devs::ModelSymbols& symbols,
+               const vpz::Vpz& vpz)
+{
+    for (const auto& elem : vpz.project().dynamics().dynamiclist()) {
+        try {
+            symbols.get(context, elem.second);
+        } catch (const std::exception& /*e*/) {
+        }
+    }
+
+    const auto& outputs = vpz.project().experiment().views().outputs();
+    for (const auto& elem : outputs.outputlist()) {
+        if (elem.second.package().empty())
+            continue;
+
+        try {
+            utils::get_symbol(context,
+                              elem.second.package(),
+                              elem.second.plugin(),
+                              utils::Context::ModuleType::MODULE_OOV);
+        } catch (const std::exception& /*e*/) {
+        }
+    }
+}
+
+/**
+ * Run the simulation of @e vpz in a forked child and returns the reply
+ * message of the server.
+ */
+inline std::string
+server_simulate(utils::ContextPtr context,
+                std::shared_ptr<devs::ModelSymbols> symbols,
+                vpz::Vpz& vpz,
+                std::chrono::milliseconds timeout)
+{
+    int pipefd[2];
+    if (::pipe(pipefd))
+        return utils::format("Efail to create pipe: %s", strerror(errno));
+
+    pid_t pid = ::fork();
+    if (pid < 0) {
+        ::close(pipefd[0]);
+        ::close(pipefd[1]);
+        return utils::format("Efail to fork: %s", strerror(errno));
+    }
+
+    if (pid == 0) {
+        ::close(pipefd[0]);
+
+        if (timeout > std::chrono::milliseconds::zero()) {
+            struct itimerval timer = {};
+            timer.it_value.tv_sec = static_cast<long>(timeout.count() / 1000);
+            timer.it_value.tv_usec =
+              static_cast<long>((timeout.count() % 1000) * 1000);
+            ::signal(SIGALRM, SIG_DFL);
+            ::setitimer(ITIMER_REAL, &timer, nullptr);
+        }
+
+        std::string out;
+        int code = EXIT_SUCCESS;
+
+        try {
+            devs::RootCoordinator root(context);
+            root.load(vpz.project(), vpz.project().model(), symbols);
+            root.init();
+            while (root.run()) {
+            }
+
+            auto result = root.finish();
+            out.assign(1, 'R');
+            if (result)
+                value::writeBinary(*result, out);
+        } catch (const std::exception& e) {
+            out = "E";
+            out += e.what();
+            code = EXIT_FAILURE;
+        }
+
+        const char* ptr = out.data();
+        std::size_t size = out.size();
+        while (size) {
+            ssize_t ret = ::write(pipefd[1], ptr, size);
+            if (ret < 0 and errno == EINTR)
+                continue;
+            if (ret <= 0)
+                break;
+            ptr += ret;
+            size -= static_cast<std::size_t>(ret);
+        }
+
+        ::_exit(code);
+    }
+
+    ::close(pipefd[1]);
+
+    std::string out;
+    char buffer[BUFSIZ];
+    for (;;) {
+        ssize_t ret = ::read(pipefd[0], buffer, sizeof(buffer));
+        if (ret < 0 and errno == EINTR)
+            continue;
+        if (ret <= 0)
+            break;
+        out.append(buffer, static_cast<std::size_t>(ret));
+    }
+    ::close(pipefd[0]);
+
+    int status = 0;
+    while (::waitpid(pid, &status, 0) == -1 and errno == EINTR)
+        ;
+
+    if (WIFEXITED(status) and not out.empty())
+        return out;
+
+    if (WIFSIGNALED(status) and WTERMSIG(status) == SIGALRM)
+        return utils::format("Esimulation timeout (%ld ms)",
+                             static_cast<long>(timeout.count()));
+
+    if (WIFSIGNALED(status))
+        return utils::format("Ekilled by signal %d", WTERMSIG(status));
+
+    return utils::format("Eexits with code %d", WEXITSTATUS(status));
+}
+
+/**
+ * Server loop: read the requests on @e fd until the client closes the
+ * connection.
+ */
+inline bool
+server_serve(utils::ContextPtr context, int fd)
+{
+    auto symbols = std::make_shared<devs::ModelSymbols>();
+    std::string buffer;
+
+    const char ready = 'S';
+    if (not server_write(fd, &ready, 1))
+        return false;
+
+    for (;;) {
+        std::uint32_t size;
+        std::int64_t timeout;
+
+        if (not server_read(fd, &size, sizeof(size)))
+            return true;
+
+        if (not server_read(fd, &timeout, sizeof(timeout)))
+            return false;
+
+        buffer.resize(size);
+        if (not server_read(fd, &buffer[0], size))
+            return false;
+
+        std::string reply;
+        try {
+            vpz::Vpz vpz;
+            vpz.parseMemory(buffer);
+            server_preload(context, *symbols, vpz);
+            reply = server_simulate(
+              context, symbols, vpz, std::chrono::milliseconds(timeout));
+        } catch (const std::exception& e) {
+            reply = "E";
+            reply += e.what();
+        }
+
+        if (not server_reply(fd, reply[0], reply.substr(1)))
+            return false;
+    }
+}
+
+/**
+ * @brief Client of a simulation server, owned by a @c Simulation. The
+ * server is started by @c start and stopped when the client is destroyed.
+ */
+class simulation_server
+{
+public:
+    simulation_server(utils::ContextPtr context)
+      : m_context(std::move(context))
+    {}
+
+    simulation_server(const simulation_server&) = delete;
+    simulation_server& operator=(const simulation_server&) = delete;
+
+    ~simulation_server()
+    {
+        stop();
+    }
+
+    bool is_running() const
+    {
+        return m_fd >= 0;
+    }
+
+    /**
+     * Start the server with the @e vle.command.vle.server command and wait
+     * for its ready byte. An empty command disables the server.
+     *
+     * @return false if the server can not be started: the command is not
+     * found, the exec fails or the process exits (or does not answer
+     * before @e startup_timeout) without serving.
+     */
+    bool start()
+    {
+        std::string command;
+        if (not m_context->get_setting("vle.command.vle.server", &command) or
+            command.empty())
+            return false;
+
+        int sockets[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets)) {
+            m_context->error(_("Simulation server: socketpair failure: %s\n"),
+                             strerror(errno));
+            return false;
+        }
+
+        //
+        // All the memory is allocated before the fork: the other threads
+        // of the manager may hold the locks of the allocator.
+        //
+
+        std::vector<std::string> args;
+        std::vector<char*> argv;
+        try {
+            utils::Spawn spawn(m_context);
+            args = spawn.splitCommandLine(
+              (boost::format(command) % sockets[1]).str());
+
+            if (args.front().empty())
+                throw utils::ArgError(_("program not found"));
+
+            for (auto& arg : args)
+                argv.push_back(&arg[0]);
+            argv.push_back(nullptr);
+        } catch (const std::exception& e) {
+            m_context->error(_("Simulation server: bad command `%s': %s\n"),
+                             command.c_str(),
+                             e.what());
+            ::close(sockets[0]);
+            ::close(sockets[1]);
+            return false;
+        }
+
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            m_context->error(_("Simulation server: fork failure: %s\n"),
+                             strerror(errno));
+            ::close(sockets[0]);
+            ::close(sockets[1]);
+            return false;
+        }
+
+        if (pid == 0) {
+            ::fcntl(sockets[1], F_SETFD, 0);
+            ::execv(argv[0], argv.data());
+            ::_exit(127);
+        }
+
+        ::close(sockets[1]);
+        m_fd = sockets[0];
+        m_pid = pid;
+
+        if (not wait_ready()) {
+            m_context->error(_("Simulation server: `%s' does not start\n"),
+                             args.front().c_str());
+            ::kill(m_pid, SIGKILL);
+            stop();
+            return false;
+        }
+
+        m_context->debug(_("Simulation server: `%s' started (%d)\n"),
+                         args.front().c_str(),
+                         static_cast<int>(pid));
+
+        return true;
+    }
+
+    void stop()
+    {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+
+        if (m_pid > 0) {
+            while (::waitpid(m_pid, nullptr, 0) == -1 and errno == EINTR)
+                ;
+            m_pid = -1;
+        }
+    }
+
+    /**
+     * Run the simulation @e vpz in the server.
+     *
+     * @return false if the server fails, the server is stopped. Otherwise
+     * @e result is filled or @e error is assigned.
+     */
+    bool run(const vpz::Vpz& vpz,
+             std::chrono::milliseconds timeout,
+             std::unique_ptr<value::Map>& result,
+             Error* error)
+    {
+        std::string buffer = vpz.writeToString();
+        std::uint32_t size = static_cast<std::uint32_t>(buffer.size());
+        std::int64_t ms = static_cast<std::int64_t>(timeout.count());
+
+        if (not server_write(m_fd, &size, sizeof(size)) or
+            not server_write(m_fd, &ms, sizeof(ms)) or
+            not server_write(m_fd, buffer.data(), buffer.size()) or
+            not server_read(m_fd, &size, sizeof(size)) or size == 0) {
+            stop();
+            return false;
+        }
+
+        buffer.resize(size);
+        if (not server_read(m_fd, &buffer[0], size)) {
+            stop();
+            return false;
+        }
+
+        if (buffer[0] == 'R') {
+            error->code = 0;
+            if (size > 1) {
+                auto value = value::readBinary(buffer.data() + 1, size - 1);
+                if (value and value->isMap())
+                    result.reset(static_cast<value::Map*>(value.release()));
+            }
+        } else {
+            error->code = -1;
+            error->message = utils::format(_("\n/!\\ error reported: %s\n"),
+                                           buffer.c_str() + 1);
+        }
+
+        return true;
+    }
+
+private:
+    /** Time given to the server to send its ready byte. */
+    static constexpr int startup_timeout = 30000; // in milliseconds
+
+    utils::ContextPtr m_context;
+    pid_t m_pid = -1;
+    int m_fd = -1;
+
+    /**
+     * Wait for the ready byte of the server. A failed exec or a server
+     * which exits closes the socket before.
+     */
+    bool wait_ready()
+    {
+        struct pollfd pfd = { m_fd, POLLIN, 0 };
+        int ret;
+
+        do {
+            ret = ::poll(&pfd, 1, startup_timeout);
+        } while (ret == -1 and errno == EINTR);
+
+        char ready = 0;
+        return ret > 0 and server_read(m_fd, &ready, 1) and ready == 'S';
+    }
+};
+
+#endif
+
+}
+} // namespace vle manager
+
+#endif
@@ -3,9 +3,14 @@
 #ifndef VLE_MANAGER_DETAILS_THREAD_SPECIFIC_HPP_
 #define VLE_MANAGER_DETAILS_THREAD_SPECIFIC_HPP_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <fstream>
+#include <numeric>
+#include <vector>
 
 
 namespace vle {
@@ -92,6 +97,67 @@ struct thread_log : vle::utils::Context::LogFunctor
 };
 
 
+/**
+ * The @c simulation_queue distributes the simulations of the plan to the
+ * thread workers: each worker takes the next simulation as soon as it
+ * finishes the previous one. Simulations are taken in the natural order
+ * (input_index * M + replicate_index) or, if expected durations of the
+ * inputs are provided, longest expected first.
+ */
+struct simulation_queue
+{
+    std::vector<uint32_t> mOrder;//empty for the natural order
+    std::atomic<uint32_t> mNext;
+    uint32_t mSize;
+
+    simulation_queue(uint32_t size):
+        mOrder(), mNext(0), mSize(size)
+    {}
+
+    /**
+     * @brief Sort the simulations by decreasing expected duration.
+     * @param [in] durations, the expected duration of each input
+     * @param [in] M, the number of replicates
+     */
+    void sort(const std::vector<double>& durations, uint32_t M)
+    {
+        mOrder.resize(mSize);
+        std::iota(mOrder.begin(), mOrder.end(), 0);
+        std::stable_sort(mOrder.begin(), mOrder.end(),
+                [&durations, M](uint32_t a, uint32_t b) {
+                    return durations[a / M] > durations[b / M];
+                });
+    }
+
+    /**
+     * @brief Get the next simulation to run.
+     * @param [out] index, the index of the simulation
+     * @return false if all simulations are taken
+     */
+    bool pop(uint32_t& index)
+    {
+        uint32_t next = mNext.fetch_add(1, std::memory_order_relaxed);
+        if (next >= mSize) {
+            return false;
+        }
+        index = mOrder.empty() ? next : mOrder[next];
+        return true;
+    }
+};
+
+/**
+ * The @c thread_usage stores the work done by a thread worker.
+ */
+struct thread_usage
+{
+    std::chrono::steady_clock::duration busy;
+    uint32_t simulations;
+
+    thread_usage():
+        busy(std::chrono::steady_clock::duration::zero()), simulations(0)
+    {}
+};
+
 /**
  * The @c worker is a boost thread functor to execute threaded
  * source code.
@@ -103,14 +169,15 @@ struct thread_worker
     const vpz::Vpz& mVpz;
     const wrapper_init& mInit;
     const ManagerObjects& mManObjs;
-    std::vector<std::unique_ptr<ManOutput>>& mOutputs;//to fill
-    value::Map&               mResults;//to fill
-    std::mutex&                mMutex;
+    std::vector<std::unique_ptr<ManOutput>>& mOutputs;//to fill, own outputs
+    value::Map&               mResults;//to fill, own results
+    std::mutex&                mMutex;//for mError and mOutput
     std::chrono::milliseconds mTimeout;
     SimulationOptions         mSimulationOption;
-    uint32_t                  mIndex;
-    uint32_t                  mThreads;
+    simulation_queue&         mQueue;
+    thread_usage&             mUsage;//to fill
     Error&                    mError;//tofill
+    const Manager::result_function* mOutput;//if set, no aggregation
 
     thread_worker(utils::ContextPtr context,
             const vpz::Vpz& vpz,
@@ -121,13 +188,15 @@ struct thread_worker
             std::mutex& results_mutex,
             std::chrono::milliseconds timeout,
             SimulationOptions simulationOption,
-            uint32_t index,
-            uint32_t threads,
-            Error& error):
+            simulation_queue& queue,
+            thread_usage& usage,
+            Error& error,
+            const Manager::result_function* output = nullptr):
                 mContext(context), mVpz(vpz), mInit(init), mManObjs(manObjs),
                 mOutputs(outputs), mResults(results), mMutex(results_mutex),
                 mTimeout(timeout), mSimulationOption(simulationOption),
-                mIndex(index), mThreads(threads), mError(error)
+                mQueue(queue), mUsage(usage), mError(error),
+                mOutput(output)
     {}
 
     ~thread_worker() = default;
@@ -137,13 +206,44 @@ struct thread_worker
         unsigned int N = mManObjs.inputsSize();
         unsigned int M = mManObjs.replicasSize();
 
+        //without spawn, the model is prepared once for all simulations
+        //with spawn, the simulation keeps its server for all simulations
+        std::unique_ptr<PreparedSimulation> prepared;
+        std::unique_ptr<Simulation> sim;
+        if (not (mSimulationOption & SIMULATION_SPAWN_PROCESS)) {
+            prepared.reset(new PreparedSimulation(mContext,
+                    std::unique_ptr<vpz::Vpz>(new vpz::Vpz(mVpz))));
+        } else {
+            sim.reset(new Simulation(mContext, mSimulationOption, mTimeout));
+        }
+
         std::shared_ptr<value::Value> temp_val;
-        for (unsigned int  i =  mIndex; i < M*N; i += mThreads) {
+        uint32_t i;
+        while (mQueue.pop(i)) {
+            auto start = std::chrono::steady_clock::now();
             unsigned int inputIndex = i / M;
             unsigned int replIndex = i % M;
-            Simulation sim(mContext, mSimulationOption, mTimeout);
 
-            std::unique_ptr<vpz::Vpz> vpz_loc(new vpz::Vpz(mVpz));
+            std::unique_ptr<vpz::Vpz> vpz_loc;
+            if (not prepared) {
+                vpz_loc.reset(new vpz::Vpz(mVpz));
+            }
+            auto setPort = [&](const std::string& cond,
+                    const std::string& port) {
+                if (prepared) {
+                    prepared->setConditionPort(cond, port, temp_val);
+                } else {
+                    vpz_loc->project().experiment().conditions()
+                            .get(cond).setValueToPort(port, temp_val);
+                }
+            };
+            if (mOutput) {
+                if (prepared) {
+                    prepared->setInstance(i);
+                } else {
+                    vpz_loc->project().setInstance(i);
+                }
+            }
 
             for (auto& tmp_input : mManObjs.mInputs) {
                 const value::Value& exp = tmp_input->values(mInit);
@@ -166,9 +266,7 @@ struct thread_worker
                     }
                     break;
                 }
-                vpz_loc->project().experiment().conditions()
-                                  .get(tmp_input->cond)
-                                  .setValueToPort(tmp_input->port, temp_val);
+                setPort(tmp_input->cond, tmp_input->port);
             }
             for (auto& tmp_repl : mManObjs.mReplicates) {
                 const value::Value& exp = tmp_repl->values(mInit);
@@ -190,12 +288,17 @@ struct thread_worker
                         return ;
                     }
                 }
-                vpz_loc->project().experiment().conditions()
-                                  .get(tmp_repl->cond)
-                                  .setValueToPort(tmp_repl->port, temp_val);
+                setPort(tmp_repl->cond, tmp_repl->port);
             }
             Error error_loc;
-            auto simresult = sim.run(std::move(vpz_loc), &error_loc);
+            std::unique_ptr<value::Map> simresult;
+            if (prepared) {
+                simresult = prepared->run(&error_loc);
+            } else {
+                simresult = sim->run(std::move(vpz_loc), &error_loc);
+            }
+            mUsage.busy += std::chrono::steady_clock::now() - start;
+            mUsage.simulations++;
 
             //////////////////
             mMutex.lock();
@@ -212,6 +315,26 @@ struct thread_worker
                 mMutex.unlock();
                 return ;
             }
+            if (mOutput) {
+                try {
+                    (*mOutput)(inputIndex, replIndex, std::move(simresult));
+                } catch (const std::exception& e) {
+                    mError.code = -1;
+                    mError.message = "[Manager error] output input="+
+                            std::to_string(inputIndex)+
+                            ", replicate="+std::to_string(replIndex)+" : "+
+                            e.what();
+                }
+                mMutex.unlock();
+                if (mError.code) {
+                    return;
+                }
+                continue;
+            }
+            mMutex.unlock();
+
+            //outputs and results are owned by the worker: no lock is
+            //required for the aggregation
             try {
                 std::unique_ptr<value::Value> aggr_value;
                 for (unsigned int out=0; out<mOutputs.size(); out++) {
@@ -223,6 +346,7 @@ struct thread_worker
                     }
                 }
             } catch ( const std::exception& e) {
+                mMutex.lock();
                 mError.code = -1;
                 mError.message = "[Manager error] aggregation input="+
                         std::to_string(inputIndex)+
@@ -231,7 +355,6 @@ struct thread_worker
                 mMutex.unlock();
                 return ;
             }
-            mMutex.unlock();
         }
     }
 };
@@ -158,9 +158,10 @@ public:
      * @param vpz, the model to modify
      * @param view, the name of the view
      * @param plugin, the name of the new plugin
+     * @param columnar, for the storage plugin, store the values by columns
      */
     static void changePlugin(vz::Vpz& vpz, const std::string& view,
-        const std::string& plugin)
+        const std::string& plugin, bool columnar = false)
     {
         vz::Views& vle_views = vpz.project().experiment().views();
         vz::Output& out = vle_views.outputs().get(view);
@@ -170,12 +171,43 @@ public:
         if(plugin == "storage"){
             std::unique_ptr<vv::Value> configOutput = vv::Map::create();
             configOutput->toMap().addString("header","top");
+            if (columnar) {
+                configOutput->toMap().addBoolean("columnar", true);
+            }
             out.setData(std::move(configOutput));
 
         }
 
     }
 
+    /**
+     * @brief Change the output plugin for a view to a plugin registered
+     * into the context (without package)
+     * @param vpz, the model to modify
+     * @param view, the name of the view
+     * @param plugin, the name of the factory of the plugin
+     * @param data, the parameters of the plugin
+     */
+    static void changePlugin(vz::Vpz& vpz, const std::string& view,
+        const std::string& plugin, std::unique_ptr<vv::Value> data)
+    {
+        vz::Views& vle_views = vpz.project().experiment().views();
+        vz::Output& out = vle_views.outputs().get(view);
+        out.setStream("", plugin, "");
+        out.setData(std::move(data));
+    }
+
+    /**
+     * @brief Tells if a view is a timed or a finish view
+     * @param vpz, the model
+     * @param view, the name of the view
+     */
+    static bool isTimedOrFinish(const vz::Vpz& vpz, const std::string& view)
+    {
+        const vz::View& v = vpz.project().experiment().views().get(view);
+        return v.type() == vz::View::TIMED or v.type() == vz::View::FINISH;
+    }
+
 };
 
 }
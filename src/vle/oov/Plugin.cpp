@@ -25,7 +25,24 @@
  */
 
 #include <vle/oov/Plugin.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
 
 namespace vle {
-namespace oov {}
+namespace oov {
+
+void
+Plugin::onHandleReal(std::int32_t handle, const double& time, double value)
+{
+    onHandleValue(handle, time, value::Double::create(value));
+}
+
+void
+Plugin::onHandleInteger(std::int32_t handle,
+                        const double& time,
+                        std::int32_t value)
+{
+    onHandleValue(handle, time, value::Integer::create(value));
+}
+}
 } // namespace vle oov
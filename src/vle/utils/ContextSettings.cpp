@@ -106,7 +106,8 @@ Context::reset_settings() noexcept
         { "gvle.graphics.font-size", 10.0 },
         { "gvle.graphics.line-width", 3.0 },
         { "vle.simulation.thread", 0l },
-        { "vle.simulation.block-size", 8l },
+        { "vle.simulation.block-size", 0l },
+        { "vle.simulation.scheduler", std::string("heap") },
         { "vle.packages.configure",
           std::string(VLE_PACKAGE_COMMAND_CONFIGURE) },
         { "vle.packages.test", std::string(VLE_PACKAGE_COMMAND_TEST) },
@@ -132,12 +133,19 @@ Context::reset_settings() noexcept
     std::string simulation = "";
 #ifdef _WIN32
     simulation = "vle.exe";
-    simulation += " --write-output '%1%' '%2%'";
+    simulation += " --binary-output --write-output '%1%' '%2%'";
 #else
     simulation = utils::format("vle-%s", vle::string_version_abi().c_str());
-    simulation += " --write-output '%1%' '%2%'";
+    simulation += " --binary-output --write-output '%1%' '%2%'";
 #endif
     m_pimpl->settings["vle.command.vle.simulation"] = simulation;
+
+    std::string server = "";
+#ifndef _WIN32
+    server = utils::format("vle-%s --simulation-server %%1%%",
+                           vle::string_version_abi().c_str());
+#endif
+    m_pimpl->settings["vle.command.vle.server"] = server;
 }
 
 bool
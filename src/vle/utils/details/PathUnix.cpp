@@ -102,8 +102,9 @@ Context::findLibrary(const std::string& lib)
 #endif
 
     std::vector<std::string> splitVec;
-    boost::split(
-      splitVec, env_p, boost::is_any_of(":"), boost::token_compress_on);
+    if (env_p)
+        boost::split(
+          splitVec, env_p, boost::is_any_of(":"), boost::token_compress_on);
 
     splitVec.insert(splitVec.begin(), "/usr/lib");
     splitVec.insert(splitVec.begin(), "/usr/local/lib");
@@ -127,8 +128,9 @@ Context::findProgram(const std::string& exe)
     char* env_p = std::getenv("PATH");
 
     std::vector<std::string> splitVec;
-    boost::split(
-      splitVec, env_p, boost::is_any_of(":"), boost::token_compress_on);
+    if (env_p)
+        boost::split(
+          splitVec, env_p, boost::is_any_of(":"), boost::token_compress_on);
 
     std::vector<std::string>::const_iterator itb = splitVec.begin();
     std::vector<std::string>::const_iterator ite = splitVec.end();
@@ -42,9 +42,15 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <poll.h>
+#include <signal.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
 #ifdef __APPLE__
 #include <crt_externs.h>
 #include <signal.h>
@@ -128,23 +134,31 @@ prepare_environment_variable()
 static int
 input_timeout(int fd, std::chrono::milliseconds wait)
 {
-    fd_set set;
-    struct timeval timeout;
-    long int result;
-
-    FD_ZERO(&set);
-    FD_SET(fd, &set);
-
-    wait *= 1000;
-
-    timeout.tv_sec = 0;
-    timeout.tv_usec = wait.count();
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    int result;
 
     do {
-        result = select(FD_SETSIZE, &set, nullptr, nullptr, &timeout);
-    } while (result == -1L && errno == EINTR);
+        result = ::poll(&pfd, 1, static_cast<int>(wait.count()));
+    } while (result == -1 && errno == EINTR);
 
-    return static_cast<int>(result);
+    return result;
+}
+
+/**
+ * @e open_pidfd returns a file descriptor readable when the process @e pid
+ * ends (Linux 5.3 and later) or -1 if not available.
+ */
+static int
+open_pidfd(pid_t pid)
+{
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    return static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+#elif defined(__linux__)
+    return static_cast<int>(::syscall(434, pid, 0));
+#else
+    (void)pid;
+    return -1;
+#endif
 }
 
 class Spawn::Pimpl
@@ -257,6 +271,169 @@ public:
         return true;
     }
 
+    /**
+     * Read the available data of the pipe @e fd into @e str.
+     *
+     * @return false if the pipe is closed.
+     */
+    bool read_pipe(int fd, std::string* str)
+    {
+        char buffer[BUFSIZ];
+        ssize_t size;
+
+        do {
+            size = ::read(fd, buffer, BUFSIZ);
+        } while (size == -1 && errno == EINTR);
+
+        if (size > 0 and str)
+            str->append(buffer, size);
+
+        return size > 0;
+    }
+
+    bool wait(std::string* output,
+              std::string* error,
+              std::chrono::milliseconds timeout,
+              const OutputReader* reader = nullptr)
+    {
+        assert(m_start);
+
+        using clock = std::chrono::steady_clock;
+        const auto deadline = clock::now() + timeout;
+        const bool has_timeout = timeout > std::chrono::milliseconds::zero();
+        const int pidfd = m_finish ? -1 : open_pidfd(m_pid);
+        bool out_open = true;
+        bool err_open = true;
+        bool expired = false;
+        bool success = true;
+
+        //
+        // The thread sleeps into poll until the child writes on its outputs,
+        // closes them or ends (pidfd). Without pidfd, the end of the process
+        // is detected when both outputs are closed.
+        //
+
+        while (not m_finish) {
+            struct pollfd fds[3];
+            nfds_t nb = 0;
+
+            if (out_open)
+                fds[nb++] = { m_pipeout[0], POLLIN, 0 };
+            if (err_open)
+                fds[nb++] = { m_pipeerr[0], POLLIN, 0 };
+            if (pidfd >= 0)
+                fds[nb++] = { pidfd, POLLIN, 0 };
+
+            int wait = -1;
+            if (has_timeout) {
+                auto remaining =
+                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - clock::now());
+
+                if (remaining.count() <= 0) {
+                    expired = true;
+                    break;
+                }
+
+                wait = static_cast<int>(remaining.count()) + 1;
+            }
+
+            //
+            // Without pidfd and with both outputs closed, only waitpid can
+            // detect the end of the process: it is polled until the
+            // deadline to kill a process which outlives its outputs.
+            //
+
+            if (nb == 0) {
+                const int options = wait < 0 ? 0 : WNOHANG;
+                pid_t result;
+                do {
+                    result = ::waitpid(m_pid, &m_status, options);
+                } while (result == -1 and errno == EINTR);
+
+                if (result != 0) {
+                    m_finish = true;
+                    break;
+                }
+
+                std::this_thread::sleep_for(
+                  std::chrono::milliseconds(std::min(wait, 10)));
+                continue;
+            }
+
+            int result = ::poll(fds, nb, wait);
+            if (result == -1) {
+                if (errno == EINTR)
+                    continue;
+
+                m_context->log(VLE_LOG_ALERT,
+                               _("Spawn: wait child fail: %s\n"),
+                               strerror(errno));
+                success = false;
+                break;
+            }
+
+            for (nfds_t i = 0; i != nb; ++i) {
+                if (not fds[i].revents)
+                    continue;
+
+                if (fds[i].fd == m_pipeout[0])
+                    out_open = read_pipe(m_pipeout[0], output);
+                else if (fds[i].fd == m_pipeerr[0])
+                    err_open = read_pipe(m_pipeerr[0], error);
+                else {
+                    while (::waitpid(m_pid, &m_status, 0) == -1 and
+                           errno == EINTR)
+                        ;
+                    m_finish = true;
+                }
+            }
+
+            give(output, error, reader);
+        }
+
+        if (pidfd >= 0)
+            ::close(pidfd);
+
+        if (expired) {
+            ::kill(m_pid, SIGKILL);
+            while (::waitpid(m_pid, &m_status, 0) == -1 and errno == EINTR)
+                ;
+            m_finish = true;
+            m_msg += utils::format(_("[%s] (%d) killed after %ld ms\n"),
+                                   m_command.c_str(),
+                                   static_cast<int>(m_pid),
+                                   static_cast<long>(timeout.count()));
+        }
+
+        //
+        // Reads the data written before the end of the process.
+        //
+
+        while (out_open and input_timeout(m_pipeout[0],
+                                          std::chrono::milliseconds(0)) > 0)
+            out_open = read_pipe(m_pipeout[0], output);
+
+        while (err_open and input_timeout(m_pipeerr[0],
+                                          std::chrono::milliseconds(0)) > 0)
+            err_open = read_pipe(m_pipeerr[0], error);
+
+        give(output, error, reader);
+
+        return success and not expired;
+    }
+
+    static void give(std::string* output,
+                     std::string* error,
+                     const OutputReader* reader)
+    {
+        if (reader and (not output->empty() or not error->empty())) {
+            (*reader)(*output, *error);
+            output->clear();
+            error->clear();
+        }
+    }
+
     bool initchild(const Path& exe,
                    const Path& workingdir,
                    std::vector<std::string> args)
@@ -458,6 +635,22 @@ Spawn::wait()
     return m_pimpl->wait();
 }
 
+bool
+Spawn::wait(std::string* output,
+            std::string* error,
+            std::chrono::milliseconds timeout)
+{
+    return m_pimpl->wait(output, error, timeout);
+}
+
+bool
+Spawn::wait(const OutputReader& reader, std::chrono::milliseconds timeout)
+{
+    std::string output, error;
+
+    return m_pimpl->wait(&output, &error, timeout, &reader);
+}
+
 void
 Spawn::kill()
 {
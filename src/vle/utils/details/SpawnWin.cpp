@@ -281,6 +281,75 @@ struct Spawn::Pimpl
         return true;
     }
 
+    bool wait(std::string* output,
+              std::string* error,
+              std::chrono::milliseconds timeout,
+              const OutputReader* reader = nullptr)
+    {
+        assert(m_start);
+
+        //
+        // Anonymous pipes can not be waited with the process handle, the
+        // thread sleeps into WaitForSingleObject between two reads of the
+        // pipes.
+        //
+
+        using clock = std::chrono::steady_clock;
+        const auto deadline = clock::now() + timeout;
+        const bool has_timeout = timeout > std::chrono::milliseconds::zero();
+        bool expired = false;
+        std::string out, err;
+
+        for (;;) {
+            DWORD slice = 10;
+            if (has_timeout) {
+                auto remaining =
+                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - clock::now());
+
+                if (remaining.count() <= 0) {
+                    TerminateProcess(m_pi.hProcess, 1);
+                    expired = true;
+                    wait();
+                    get(&out, &err);
+                    break;
+                }
+
+                slice = std::min(slice, static_cast<DWORD>(remaining.count()));
+            }
+
+            bool ended =
+              WaitForSingleObject(m_pi.hProcess, slice) == WAIT_OBJECT_0;
+
+            get(&out, &err);
+
+            if (ended) {
+                wait();
+                get(&out, &err);
+                break;
+            }
+
+            if (reader and (not out.empty() or not err.empty())) {
+                (*reader)(out, err);
+                out.clear();
+                err.clear();
+            }
+        }
+
+        if (reader) {
+            if (not out.empty() or not err.empty())
+                (*reader)(out, err);
+            return not expired;
+        }
+
+        if (output)
+            output->append(out);
+        if (error)
+            error->append(err);
+
+        return not expired;
+    }
+
     bool start(const Path& exe,
                const Path& workingdir,
                const std::vector<std::string>& args)
@@ -479,6 +548,20 @@ Spawn::wait()
     return m_pimpl->wait();
 }
 
+bool
+Spawn::wait(std::string* output,
+            std::string* error,
+            std::chrono::milliseconds timeout)
+{
+    return m_pimpl->wait(output, error, timeout);
+}
+
+bool
+Spawn::wait(const OutputReader& reader, std::chrono::milliseconds timeout)
+{
+    return m_pimpl->wait(nullptr, nullptr, timeout, &reader);
+}
+
 void
 Spawn::kill()
 {
@@ -0,0 +1,369 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/Exception.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Null.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/value/XML.hpp>
+
+#include "utils/i18n.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace vle {
+namespace value {
+
+namespace {
+
+const char binary_magic[4] = { 'V', 'L', 'E', 'B' };
+const std::uint8_t binary_version = 1;
+
+// Tag of an empty cell of a Matrix, the other tags are Value::type.
+const std::uint8_t binary_empty_tag = 0xff;
+
+class BinaryWriter
+{
+    std::string& m_out;
+
+    template<typename T>
+    void put(T value)
+    {
+        m_out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void put_size(std::size_t size)
+    {
+        if (size > UINT32_MAX)
+            throw utils::ArgError(_("Binary: too many elements"));
+
+        put(static_cast<std::uint32_t>(size));
+    }
+
+    void put_string(const std::string& str)
+    {
+        put_size(str.size());
+        m_out.append(str);
+    }
+
+    void put_reals(const double* values, std::size_t size)
+    {
+        m_out.append(reinterpret_cast<const char*>(values),
+                     size * sizeof(double));
+    }
+
+public:
+    BinaryWriter(std::string& out)
+      : m_out(out)
+    {}
+
+    void write(const Value* value)
+    {
+        if (not value) {
+            put(binary_empty_tag);
+            return;
+        }
+
+        put(static_cast<std::uint8_t>(value->getType()));
+
+        switch (value->getType()) {
+        case Value::BOOLEAN:
+            put(static_cast<std::uint8_t>(value->toBoolean().value()));
+            break;
+        case Value::INTEGER:
+            put(static_cast<std::int32_t>(value->toInteger().value()));
+            break;
+        case Value::DOUBLE:
+            put(value->toDouble().value());
+            break;
+        case Value::STRING:
+            put_string(value->toString().value());
+            break;
+        case Value::XMLTYPE:
+            put_string(value->toXml().value());
+            break;
+        case Value::NIL:
+            break;
+        case Value::SET: {
+            const auto& set = value->toSet();
+            put_size(set.size());
+            for (const auto& elem : set)
+                write(elem.get());
+        } break;
+        case Value::MAP: {
+            const auto& map = value->toMap();
+            put_size(map.size());
+            for (const auto& elem : map) {
+                put_string(elem.first);
+                write(elem.second.get());
+            }
+        } break;
+        case Value::TUPLE: {
+            const auto& tuple = value->toTuple().value();
+            put_size(tuple.size());
+            put_reals(tuple.data(), tuple.size());
+        } break;
+        case Value::TABLE: {
+            const auto& table = value->toTable();
+            put_size(table.width());
+            put_size(table.height());
+            put_reals(table.value().data(), table.value().size());
+        } break;
+        case Value::MATRIX:
+            write_matrix(value->toMatrix());
+            break;
+        case Value::USER:
+            throw utils::ArgError(_("Binary: user value is not supported"));
+        }
+    }
+
+    /*
+     * Each column is stored as its first cells (any value, for example
+     * the name of the column) followed by the array of the reals of the
+     * remaining cells.
+     */
+    void write_matrix(const Matrix& matrix)
+    {
+        const auto columns = matrix.columns();
+        const auto rows = matrix.rows();
+        std::vector<double> reals;
+
+        put_size(columns);
+        put_size(rows);
+
+        for (std::size_t c = 0; c != columns; ++c) {
+            std::size_t first = rows;
+            while (first > 0 and matrix.get(c, first - 1) and
+                   matrix.get(c, first - 1)->isDouble())
+                --first;
+
+            put_size(first);
+            for (std::size_t r = 0; r != first; ++r)
+                write(matrix.get(c, r).get());
+
+            reals.clear();
+            for (std::size_t r = first; r != rows; ++r)
+                reals.push_back(matrix.get(c, r)->toDouble().value());
+
+            put_reals(reals.data(), reals.size());
+        }
+    }
+};
+
+class BinaryReader
+{
+    const char* m_pos;
+    const char* m_end;
+
+    void check(std::size_t size) const
+    {
+        if (size > static_cast<std::size_t>(m_end - m_pos))
+            throw utils::ArgError(_("Binary: truncated value"));
+    }
+
+    template<typename T>
+    T get()
+    {
+        T value;
+        check(sizeof(T));
+        std::memcpy(&value, m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    std::size_t get_size()
+    {
+        return get<std::uint32_t>();
+    }
+
+    std::string get_string()
+    {
+        std::size_t size = get_size();
+        check(size);
+        std::string str(m_pos, size);
+        m_pos += size;
+        return str;
+    }
+
+    void get_reals(double* values, std::size_t size)
+    {
+        if (size > SIZE_MAX / sizeof(double))
+            throw utils::ArgError(_("Binary: truncated value"));
+
+        check(size * sizeof(double));
+        if (size > 0)
+            std::memcpy(values, m_pos, size * sizeof(double));
+        m_pos += size * sizeof(double);
+    }
+
+    void check_reals(std::size_t size) const
+    {
+        if (size > static_cast<std::size_t>(m_end - m_pos) / sizeof(double))
+            throw utils::ArgError(_("Binary: truncated value"));
+    }
+
+public:
+    BinaryReader(const char* buffer, std::size_t size)
+      : m_pos(buffer)
+      , m_end(buffer + size)
+    {}
+
+    std::unique_ptr<Value> read()
+    {
+        auto tag = get<std::uint8_t>();
+
+        switch (tag) {
+        case binary_empty_tag:
+            return {};
+        case Value::BOOLEAN:
+            return Boolean::create(get<std::uint8_t>() != 0);
+        case Value::INTEGER:
+            return Integer::create(get<std::int32_t>());
+        case Value::DOUBLE:
+            return Double::create(get<double>());
+        case Value::STRING:
+            return String::create(get_string());
+        case Value::XMLTYPE:
+            return Xml::create(get_string());
+        case Value::NIL:
+            return Null::create();
+        case Value::SET: {
+            auto size = get_size();
+            auto set = std::unique_ptr<Set>(new Set());
+            for (std::size_t i = 0; i != size; ++i)
+                set->add(read());
+            return std::unique_ptr<Value>(std::move(set));
+        }
+        case Value::MAP: {
+            auto size = get_size();
+            auto map = std::unique_ptr<Map>(new Map());
+            for (std::size_t i = 0; i != size; ++i) {
+                auto key = get_string();
+                map->add(key, read());
+            }
+            return std::unique_ptr<Value>(std::move(map));
+        }
+        case Value::TUPLE: {
+            auto size = get_size();
+            check_reals(size);
+            auto tuple = std::unique_ptr<Tuple>(new Tuple(size));
+            get_reals(tuple->value().data(), size);
+            return std::unique_ptr<Value>(std::move(tuple));
+        }
+        case Value::TABLE: {
+            auto width = get_size();
+            auto height = get_size();
+            check_reals(width * height);
+            auto table = std::unique_ptr<Table>(new Table(width, height));
+            get_reals(table->value().data(), width * height);
+            return std::unique_ptr<Value>(std::move(table));
+        }
+        case Value::MATRIX:
+            return read_matrix();
+        default:
+            throw utils::ArgError(_("Binary: unknown value type %d"),
+                                  static_cast<int>(tag));
+        }
+    }
+
+    std::unique_ptr<Value> read_matrix()
+    {
+        auto columns = get_size();
+        auto rows = get_size();
+        auto matrix = std::unique_ptr<Matrix>(
+          new Matrix(columns, rows, columns > 0 ? columns : 1, 10));
+        std::vector<double> reals;
+
+        for (std::size_t c = 0; c != columns; ++c) {
+            auto first = get_size();
+            if (first > rows)
+                throw utils::ArgError(_("Binary: bad matrix column"));
+
+            for (std::size_t r = 0; r != first; ++r)
+                matrix->set(c, r, read());
+
+            check_reals(rows - first);
+            reals.resize(rows - first);
+            get_reals(reals.data(), reals.size());
+
+            for (std::size_t r = first; r != rows; ++r)
+                matrix->set(c, r, Double::create(reals[r - first]));
+        }
+
+        return std::unique_ptr<Value>(std::move(matrix));
+    }
+};
+
+} // anonymous namespace
+
+void
+writeBinary(const Value& value, std::string& out)
+{
+    out.append(binary_magic, sizeof(binary_magic));
+    out.append(1, static_cast<char>(binary_version));
+
+    BinaryWriter(out).write(&value);
+}
+
+bool
+isBinary(const char* buffer, std::size_t size)
+{
+    return size > sizeof(binary_magic) and
+           std::memcmp(buffer, binary_magic, sizeof(binary_magic)) == 0;
+}
+
+std::unique_ptr<Value>
+readBinary(const char* buffer, std::size_t size)
+{
+    if (not isBinary(buffer, size))
+        throw utils::ArgError(_("Binary: bad header"));
+
+    if (static_cast<std::uint8_t>(buffer[sizeof(binary_magic)]) !=
+        binary_version)
+        throw utils::ArgError(_("Binary: unsupported version %d"),
+                              static_cast<int>(static_cast<std::uint8_t>(
+                                buffer[sizeof(binary_magic)])));
+
+    BinaryReader reader(buffer + sizeof(binary_magic) + 1,
+                        size - sizeof(binary_magic) - 1);
+
+    auto value = reader.read();
+    if (not value)
+        throw utils::ArgError(_("Binary: empty value"));
+
+    return value;
+}
+}
+} // namespace vle value
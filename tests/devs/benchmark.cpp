@@ -0,0 +1,121 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmark of the event queues of the simulation kernel (the
+ * vle.simulation.scheduler setting) on the models of test_scheduler. It is
+ * not run by ctest:
+ *
+ *     benchmark_scheduler [runs]
+ *
+ * For each model and event queue, the best time of runs simulations is
+ * printed for the load and the initialization (a simulation of duration 0)
+ * and for the Coordinator::run loop (the difference with the simulation of
+ * the whole duration). The observations are removed to time the kernel
+ * only.
+ */
+
+#include <vle/utils/Filesystem.hpp>
+#include <vle/value/Double.hpp>
+
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+struct Model
+{
+    const char* name;
+    const char* file;
+    std::int32_t models;
+    double duration;
+};
+
+static double
+time_simulation(const std::string& scheduler,
+                const Model& model,
+                double duration)
+{
+    auto vpz = std::make_unique<vle::vpz::Vpz>(model.file);
+
+    auto& conditions = vpz->project().experiment().conditions();
+    conditions.get("bench").setValueToPort(
+      "models", vle::value::Integer::create(model.models));
+    conditions.get("simulation_engine")
+      .setValueToPort("duration", vle::value::Double::create(duration));
+    vpz->project().experiment().views().observables().get("obs").del("c");
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = run_simulation(scheduler, std::move(vpz));
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    if (not result) {
+        std::fprintf(stderr, "%s: simulation failed\n", model.name);
+        std::exit(EXIT_FAILURE);
+    }
+
+    return elapsed.count();
+}
+
+int
+main(int argc, char* argv[])
+{
+    const int runs = argc > 1 ? std::max(1, std::atoi(argv[1])) : 3;
+
+    vle::utils::Path::current_path(vle::utils::Path(DEVS_TEST_DIR));
+
+    const Model models[] = {
+        { "tickers-10k", DEVS_TEST_DIR "/scheduler.vpz", 10000, 200.0 },
+        { "fanout-100k", DEVS_TEST_DIR "/fanout.vpz", 100000, 100.0 }
+    };
+
+    std::printf("%-12s %-9s %14s %10s\n", "model", "queue", "load+init (s)",
+                "run (s)");
+
+    for (const auto& model : models) {
+        for (const auto& scheduler : { "heap", "calendar" }) {
+            double init = std::numeric_limits<double>::infinity();
+            double total = std::numeric_limits<double>::infinity();
+
+            for (int i = 0; i != runs; ++i) {
+                init = std::min(init, time_simulation(scheduler, model, 0.0));
+                total = std::min(
+                  total, time_simulation(scheduler, model, model.duration));
+            }
+
+            std::printf("%-12s %-9s %14.3f %10.3f\n",
+                        model.name,
+                        scheduler,
+                        init,
+                        std::max(0.0, total - init));
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/devs/ExternalEvent.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/unit-test.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+
+using namespace vle;
+
+void
+inline_value()
+{
+    devs::ExternalEvent event("out");
+    Ensures(not event.haveAttributes());
+
+    event.setDouble(1.5);
+    Ensures(event.haveAttributes());
+    EnsuresEqual(event.getDoubleValue(), 1.5);
+    EnsuresThrow(event.getIntegerValue(), utils::ArgError);
+
+    event.setInteger(3);
+    EnsuresEqual(event.getIntegerValue(), 3);
+
+    event.setBoolean(true);
+    EnsuresEqual(event.getBooleanValue(), true);
+}
+
+void
+compatibility()
+{
+    devs::ExternalEvent event("out");
+
+    event.setDouble(2.0);
+    EnsuresEqual(event.getDouble().value(), 2.0);
+    Ensures(event.attributes()->isDouble());
+
+    event.getDouble().set(4.0);
+    EnsuresEqual(event.getDoubleValue(), 4.0);
+
+    event.addInteger(5);
+    EnsuresEqual(event.getIntegerValue(), 5);
+
+    event.setDouble(6.0);
+    const devs::ExternalEvent& ref = event;
+    EnsuresEqual(ref.getDouble().value(), 6.0);
+    EnsuresEqual(ref.getDoubleValue(), 6.0);
+}
+
+void
+received_event()
+{
+    const std::string port("in");
+
+    devs::ExternalEvent event("out");
+    event.setDouble(1.0);
+
+    devs::ExternalEvent received(event, port);
+    EnsuresEqual(received.getPortName(), port);
+    Ensures(received.onPort("in"));
+    EnsuresEqual(received.getDoubleValue(), 1.0);
+
+    received.setDouble(2.0);
+    EnsuresEqual(event.getDoubleValue(), 1.0);
+}
+
+int
+main()
+{
+    inline_value();
+    compatibility();
+    received_event();
+
+    return unit_test::report_errors();
+}
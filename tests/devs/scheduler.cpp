@@ -0,0 +1,142 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/Filesystem.hpp>
+#include <vle/utils/unit-test.hpp>
+
+#include "scheduler.hpp"
+
+static void
+check_equal(const vle::value::Matrix& matrix, const vle::value::Matrix& ref)
+{
+    EnsuresEqual(matrix.columns(), ref.columns());
+    EnsuresEqual(matrix.rows(), ref.rows());
+    if (matrix.columns() != ref.columns() or matrix.rows() != ref.rows())
+        return;
+
+    for (std::size_t i = 0, e = matrix.columns(); i != e; ++i) {
+        for (std::size_t j = 0, f = matrix.rows(); j != f; ++j) {
+            const auto& value = matrix.get(i, j);
+            const auto& expected = ref.get(i, j);
+
+            Ensures(static_cast<bool>(value) == static_cast<bool>(expected));
+            if (value and expected)
+                EnsuresEqual(value->writeToString(),
+                             expected->writeToString());
+        }
+    }
+}
+
+void
+test_schedulers()
+{
+    vle::utils::Path::current_path(vle::utils::Path(DEVS_TEST_DIR));
+
+    auto reference = run_simulation("heap", DEVS_TEST_DIR "/scheduler.vpz");
+    Ensures(reference);
+    if (not reference)
+        return;
+
+    const auto& ref = reference->getMatrix("view1");
+    EnsuresEqual(ref.rows(), static_cast<std::size_t>(21));
+
+    for (const auto& scheduler : { "calendar" }) {
+        auto out = run_simulation(scheduler, DEVS_TEST_DIR "/scheduler.vpz");
+        Ensures(out);
+        if (not out)
+            continue;
+
+        check_equal(out->getMatrix("view1"), ref);
+    }
+}
+
+void
+test_unknown_scheduler()
+{
+    vle::utils::Path::current_path(vle::utils::Path(DEVS_TEST_DIR));
+
+    auto out = run_simulation("unknown", DEVS_TEST_DIR "/scheduler.vpz");
+
+    Ensures(not out);
+}
+
+void
+test_fanout()
+{
+    vle::utils::Path::current_path(vle::utils::Path(DEVS_TEST_DIR));
+
+    for (const auto& scheduler : { "heap", "calendar" }) {
+        auto out = run_simulation(scheduler, DEVS_TEST_DIR "/fanout.vpz");
+        Ensures(out);
+        if (not out)
+            continue;
+
+        const auto& matrix = out->getMatrix("view1");
+        EnsuresEqual(matrix.columns(), static_cast<std::size_t>(1001));
+        EnsuresEqual(matrix.rows(), static_cast<std::size_t>(11));
+
+        // At the date t, every receiver has counted the t + 1 events of
+        // the generator.
+        for (std::size_t i = 1, e = matrix.columns(); i < e; ++i)
+            for (std::size_t j = 0, f = matrix.rows(); j < f; ++j)
+                EnsuresEqual(vle::value::toInteger(matrix(i, j)),
+                             static_cast<std::int32_t>(j + 1));
+    }
+}
+
+void
+test_threads()
+{
+    vle::utils::Path::current_path(vle::utils::Path(DEVS_TEST_DIR));
+
+    auto reference = run_simulation("heap", DEVS_TEST_DIR "/scheduler.vpz");
+    Ensures(reference);
+    if (not reference)
+        return;
+
+    const auto& ref = reference->getMatrix("view1");
+
+    for (long threads : { 1, 4 }) {
+        auto out =
+          run_simulation("heap", DEVS_TEST_DIR "/scheduler.vpz", threads);
+        Ensures(out);
+        if (not out)
+            continue;
+
+        check_equal(out->getMatrix("view1"), ref);
+    }
+}
+
+int
+main()
+{
+    test_schedulers();
+    test_unknown_scheduler();
+    test_fanout();
+    test_threads();
+
+    return unit_test::report_errors();
+}
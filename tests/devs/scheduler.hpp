@@ -0,0 +1,281 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_DEVS_TEST_SCHEDULER_HPP
+#define VLE_DEVS_TEST_SCHEDULER_HPP
+
+#include <vle/devs/Dynamics.hpp>
+#include <vle/devs/Executive.hpp>
+#include <vle/manager/Simulation.hpp>
+#include <vle/utils/Tools.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+#include "oov.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace bench {
+
+/**
+ * Send an event on the \e out port periodically. Most of the tickers share
+ * the same dates (time-stepped models) to stress the scheduler with large
+ * bags. Events carry an inline real value.
+ */
+class Ticker : public vle::devs::Dynamics
+{
+    vle::devs::Time m_period;
+
+public:
+    Ticker(const vle::devs::DynamicsInit& init,
+           const vle::devs::InitEventList& events)
+      : vle::devs::Dynamics(init, events)
+    {
+        const auto& name = getModelName();
+        auto id = std::stoul(name.substr(name.find('-') + 1));
+
+        switch (id % 4) {
+        case 0:
+            m_period = 1.0;
+            break;
+        case 1:
+            m_period = 0.5;
+            break;
+        case 2:
+            m_period = 0.25 * (1 + id % 3);
+            break;
+        default:
+            m_period = 0.1 * (1 + id % 10);
+            break;
+        }
+    }
+
+    vle::devs::Time init(vle::devs::Time /*time*/) override
+    {
+        return m_period;
+    }
+
+    vle::devs::Time timeAdvance() const override
+    {
+        return m_period;
+    }
+
+    void output(vle::devs::Time /*time*/,
+                vle::devs::ExternalEventList& output) const override
+    {
+        output.emplace_back("out");
+        output.back().setDouble(1.0);
+    }
+};
+
+class Counter : public vle::devs::Dynamics
+{
+    std::int32_t m_counter;
+
+public:
+    Counter(const vle::devs::DynamicsInit& init,
+            const vle::devs::InitEventList& events)
+      : vle::devs::Dynamics(init, events)
+      , m_counter(0)
+    {}
+
+    void externalTransition(const vle::devs::ExternalEventList& events,
+                            vle::devs::Time /*time*/) override
+    {
+        for (const auto& event : events)
+            m_counter += static_cast<std::int32_t>(event.getDoubleValue());
+    }
+
+    void scalarObservation(const vle::devs::ObservationEvent& /*event*/,
+                           vle::devs::ScalarObservation& value) const override
+    {
+        value.setInteger(m_counter);
+    }
+};
+
+class Builder : public vle::devs::Executive
+{
+    std::int32_t m_models;
+
+public:
+    Builder(const vle::devs::ExecutiveInit& init,
+            const vle::devs::InitEventList& events)
+      : vle::devs::Executive(init, events)
+      , m_models(events.getInt("models"))
+    {}
+
+    vle::devs::Time init(vle::devs::Time /*time*/) override
+    {
+        for (std::int32_t i = 0; i != m_models; ++i) {
+            auto name = vle::utils::format("ticker-%d", i);
+            createModel(name, {}, { "out" }, "ticker");
+            addConnection(name, "out", "counter", "in");
+        }
+
+        return vle::devs::infinity;
+    }
+};
+
+/**
+ * Send an event on the \e out port at each time unit with an inline real
+ * value.
+ */
+class Generator : public vle::devs::Dynamics
+{
+public:
+    Generator(const vle::devs::DynamicsInit& init,
+              const vle::devs::InitEventList& events)
+      : vle::devs::Dynamics(init, events)
+    {}
+
+    vle::devs::Time init(vle::devs::Time /*time*/) override
+    {
+        return 0.0;
+    }
+
+    vle::devs::Time timeAdvance() const override
+    {
+        return 1.0;
+    }
+
+    void output(vle::devs::Time /*time*/,
+                vle::devs::ExternalEventList& output) const override
+    {
+        output.emplace_back("out");
+        output.back().setDouble(1.0);
+    }
+};
+
+/**
+ * Build a fan-out model: the \e generator is connected to all the
+ * receivers.
+ */
+class FanOut : public vle::devs::Executive
+{
+    std::int32_t m_models;
+
+public:
+    FanOut(const vle::devs::ExecutiveInit& init,
+           const vle::devs::InitEventList& events)
+      : vle::devs::Executive(init, events)
+      , m_models(events.getInt("models"))
+    {}
+
+    vle::devs::Time init(vle::devs::Time /*time*/) override
+    {
+        for (std::int32_t i = 0; i != m_models; ++i) {
+            auto name = vle::utils::format("receiver-%d", i);
+            createModel(name, { "in" }, {}, "receiver", {}, "obs");
+            addConnection("generator", "out", name, "in");
+        }
+
+        return vle::devs::infinity;
+    }
+};
+
+} // namespace bench
+
+/**
+ * Run the simulation of the \e file with the \e scheduler event queue
+ * and \e threads threads. The errors are written on the standard error.
+ */
+inline std::unique_ptr<vle::value::Map>
+run_simulation(const std::string& scheduler,
+               std::unique_ptr<vle::vpz::Vpz> file,
+               long threads = 0)
+{
+    using namespace std::chrono_literals;
+
+    auto ctx = vle::utils::make_context();
+    ctx->set_log_priority(3);
+    ctx->set_setting("vle.simulation.scheduler", scheduler);
+    ctx->set_setting("vle.simulation.thread", threads);
+
+    ctx->add_oov_factory("oov_plugin", [](const std::string& location) {
+        return new vletest::OutputPlugin(location);
+    });
+
+    ctx->add_dynamics_factory(
+      "dynamics_ticker",
+      [](const vle::devs::DynamicsInit& init,
+         const vle::devs::InitEventList& events) {
+          return new bench::Ticker(init, events);
+      });
+
+    ctx->add_dynamics_factory(
+      "dynamics_counter",
+      [](const vle::devs::DynamicsInit& init,
+         const vle::devs::InitEventList& events) {
+          return new bench::Counter(init, events);
+      });
+
+    ctx->add_dynamics_factory(
+      "dynamics_generator",
+      [](const vle::devs::DynamicsInit& init,
+         const vle::devs::InitEventList& events) {
+          return new bench::Generator(init, events);
+      });
+
+    ctx->add_executive_factory(
+      "exe_builder",
+      [](const vle::devs::ExecutiveInit& init,
+         const vle::devs::InitEventList& events) {
+          return new bench::Builder(init, events);
+      });
+
+    ctx->add_executive_factory(
+      "exe_fanout",
+      [](const vle::devs::ExecutiveInit& init,
+         const vle::devs::InitEventList& events) {
+          return new bench::FanOut(init, events);
+      });
+
+    vle::manager::Simulation simulator(
+      ctx, vle::manager::SIMULATION_NONE, 0ms);
+
+    vle::manager::Error error;
+    auto ret = simulator.run(std::move(file), &error);
+
+    if (error.code)
+        std::cerr << "Simulation failed with code " << error.code << " : "
+                  << error.message << '\n';
+
+    return ret;
+}
+
+inline std::unique_ptr<vle::value::Map>
+run_simulation(const std::string& scheduler,
+               const char* filename,
+               long threads = 0)
+{
+    return run_simulation(
+      scheduler, std::make_unique<vle::vpz::Vpz>(filename), threads);
+}
+
+#endif
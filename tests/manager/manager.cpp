@@ -0,0 +1,421 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/devs/Dynamics.hpp>
+#include <vle/manager/Manager.hpp>
+#include <vle/manager/PreparedSimulation.hpp>
+#include <vle/manager/Simulation.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Filesystem.hpp>
+#include <vle/utils/unit-test.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+#include "../devs/oov.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+namespace test {
+
+/**
+ * Add the \e value condition to the \e sum observable at each time unit.
+ */
+class Sum : public vle::devs::Dynamics
+{
+    double m_value;
+    double m_sum;
+
+public:
+    Sum(const vle::devs::DynamicsInit& init,
+        const vle::devs::InitEventList& events)
+      : vle::devs::Dynamics(init, events)
+      , m_value(events.getDouble("value"))
+      , m_sum(0.0)
+    {}
+
+    vle::devs::Time init(vle::devs::Time /*time*/) override
+    {
+        return 1.0;
+    }
+
+    vle::devs::Time timeAdvance() const override
+    {
+        return 1.0;
+    }
+
+    void internalTransition(vle::devs::Time /*time*/) override
+    {
+        m_sum += m_value;
+    }
+
+    std::unique_ptr<vle::value::Value> observation(
+      const vle::devs::ObservationEvent& /*event*/) const override
+    {
+        return vle::value::Double::create(m_sum);
+    }
+};
+
+} // namespace test
+
+static vle::utils::ContextPtr
+make_context()
+{
+    auto ctx = vle::utils::make_context();
+    ctx->set_log_priority(3);
+
+    ctx->add_oov_factory("oov_plugin", [](const std::string& location) {
+        return new vletest::OutputPlugin(location);
+    });
+
+    ctx->add_dynamics_factory(
+      "dynamics_sum",
+      [](const vle::devs::DynamicsInit& init,
+         const vle::devs::InitEventList& events) {
+          return new test::Sum(init, events);
+      });
+
+    return ctx;
+}
+
+static vle::value::Map
+make_plan(int inputs, int replicates)
+{
+    vle::value::Map plan;
+
+    auto values = std::make_unique<vle::value::Set>();
+    for (int i = 0; i != inputs; ++i)
+        values->add(vle::value::Double::create(i));
+    plan.add("input_cond.value", std::move(values));
+
+    auto seeds = std::make_unique<vle::value::Set>();
+    for (int i = 0; i != replicates; ++i)
+        seeds->add(vle::value::Integer::create(i));
+    plan.add("replicate_cond.replicate", std::move(seeds));
+
+    return plan;
+}
+
+void
+test_run_plan_output()
+{
+    using namespace std::chrono_literals;
+
+    vle::utils::Path::current_path(vle::utils::Path(MANAGER_TEST_DIR));
+
+    const auto plan = make_plan(5, 3);
+
+    for (auto slots : { 1u, 4u }) {
+        vle::manager::Manager manager(
+          make_context(),
+          slots > 1 ? vle::manager::PARALLEL_THREADS
+                    : vle::manager::PARALLEL_MONO,
+          slots,
+          vle::manager::SIMULATION_NONE,
+          0ms,
+          true,
+          false,
+          vle::utils::Path::temp_directory_path().string(),
+          12365);
+
+        std::set<std::pair<unsigned int, unsigned int>> simulations;
+        vle::manager::Error error;
+
+        manager.runPlan(
+          std::make_unique<vle::vpz::Vpz>(MANAGER_TEST_DIR "/manager.vpz"),
+          plan,
+          [&simulations](unsigned int input,
+                         unsigned int replicate,
+                         std::unique_ptr<vle::value::Map> result) {
+              Ensures(result);
+              if (not result)
+                  return;
+
+              Ensures(simulations.emplace(input, replicate).second);
+
+              const auto& matrix = result->getMatrix("view1");
+              EnsuresEqual(matrix.rows(), static_cast<std::size_t>(11));
+              EnsuresApproximatelyEqual(
+                vle::value::toDouble(matrix(1, 10)), 10.0 * input, 1e-10);
+          },
+          error);
+
+        EnsuresEqual(error.code, 0);
+        EnsuresEqual(simulations.size(), static_cast<std::size_t>(5 * 3));
+    }
+}
+
+static void
+add_output(vle::value::Map& plan,
+           const std::string& id,
+           const std::string& integration,
+           const std::string& input)
+{
+    auto output = std::make_unique<vle::value::Map>();
+    output->addString("path", "view1/top:sum.sum");
+    output->addString("integration", integration);
+    output->addString("aggregation_input", input);
+    if (integration == "mse") {
+        auto times = std::make_unique<vle::value::Tuple>(2);
+        times->at(1) = 4.0;
+        output->add("mse_times", std::move(times));
+        output->add("mse_observations",
+                    std::make_unique<vle::value::Tuple>(2));
+    }
+    plan.add("output_" + id, std::move(output));
+}
+
+void
+test_integration_in_simulation()
+{
+    using namespace std::chrono_literals;
+
+    vle::utils::Path::current_path(vle::utils::Path(MANAGER_TEST_DIR));
+
+    // The observation of input i at date t is i * t, t in [0, 10].
+    auto plan = make_plan(5, 3);
+    add_output(plan, "last", "last", "all");
+    add_output(plan, "max", "max", "mean");
+    add_output(plan, "sum", "sum", "max");
+    add_output(plan, "mse", "mse", "all");
+
+    for (auto slots : { 1u, 4u }) {
+        vle::manager::Manager manager(
+          make_context(),
+          slots > 1 ? vle::manager::PARALLEL_THREADS
+                    : vle::manager::PARALLEL_MONO,
+          slots,
+          vle::manager::SIMULATION_NONE,
+          0ms,
+          true,
+          false,
+          vle::utils::Path::temp_directory_path().string(),
+          12365);
+
+        vle::manager::Error error;
+        auto results = manager.runPlan(
+          std::make_unique<vle::vpz::Vpz>(MANAGER_TEST_DIR "/manager.vpz"),
+          plan,
+          error);
+
+        EnsuresEqual(error.code, 0);
+        Ensures(results);
+        if (not results)
+            return;
+
+        EnsuresApproximatelyEqual(results->getDouble("max"), 20.0, 1e-10);
+        EnsuresApproximatelyEqual(results->getDouble("sum"), 220.0, 1e-10);
+
+        const auto& last = results->get("last")->toTable();
+        const auto& mse = results->get("mse")->toTable();
+        EnsuresEqual(last.width(), static_cast<std::size_t>(5));
+        EnsuresEqual(mse.width(), static_cast<std::size_t>(5));
+        for (std::size_t i = 0; i != 5; ++i) {
+            EnsuresApproximatelyEqual(last.get(i, 0), 10.0 * i, 1e-10);
+            EnsuresApproximatelyEqual(mse.get(i, 0), 8.0 * i * i, 1e-10);
+        }
+    }
+}
+
+void
+test_expected_duration()
+{
+    using namespace std::chrono_literals;
+
+    vle::utils::Path::current_path(vle::utils::Path(MANAGER_TEST_DIR));
+
+    auto plan = make_plan(4, 2);
+    auto durations = std::make_unique<vle::value::Tuple>(4);
+    durations->at(0) = 1.0;
+    durations->at(1) = 10.0;
+    durations->at(2) = 5.0;
+    durations->at(3) = 1.0;
+    plan.add("expected_duration", std::move(durations));
+
+    vle::manager::Manager manager(
+      make_context(),
+      vle::manager::PARALLEL_MONO,
+      1,
+      vle::manager::SIMULATION_NONE,
+      0ms,
+      true,
+      false,
+      vle::utils::Path::temp_directory_path().string(),
+      12365);
+    std::vector<std::pair<unsigned int, unsigned int>> simulations;
+    vle::manager::Error error;
+
+    manager.runPlan(
+      std::make_unique<vle::vpz::Vpz>(MANAGER_TEST_DIR "/manager.vpz"),
+      plan,
+      [&simulations](unsigned int input,
+                     unsigned int replicate,
+                     std::unique_ptr<vle::value::Map> /*result*/) {
+          simulations.emplace_back(input, replicate);
+      },
+      error);
+
+    EnsuresEqual(error.code, 0);
+
+    // Longest expected first, the natural order is kept for equal
+    // durations.
+    const std::vector<std::pair<unsigned int, unsigned int>> expected = {
+        { 1, 0 }, { 1, 1 }, { 2, 0 }, { 2, 1 },
+        { 0, 0 }, { 0, 1 }, { 3, 0 }, { 3, 1 }
+    };
+
+    Ensures(simulations == expected);
+}
+
+void
+test_prepared_simulation()
+{
+    using namespace std::chrono_literals;
+
+    vle::utils::Path::current_path(vle::utils::Path(MANAGER_TEST_DIR));
+
+    const int simulations = 1000;
+    auto ctx = make_context();
+    vle::vpz::Vpz vpz(MANAGER_TEST_DIR "/manager.vpz");
+
+    // Reference: a new vpz and a new simulation for each run.
+    std::vector<double> reference;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i != simulations; ++i) {
+        auto file = std::make_unique<vle::vpz::Vpz>(vpz);
+        file->project().experiment().conditions().get("cond").setValueToPort(
+          "value", vle::value::Double::create(i));
+
+        vle::manager::Simulation sim(ctx, vle::manager::SIMULATION_NONE, 0ms);
+        vle::manager::Error error;
+        auto result = sim.run(std::move(file), &error);
+        EnsuresEqual(error.code, 0);
+        if (not result)
+            return;
+
+        reference.emplace_back(
+          vle::value::toDouble(result->getMatrix("view1")(1, 10)));
+    }
+    std::chrono::duration<double> copy = std::chrono::steady_clock::now() -
+                                         start;
+
+    // Prepared: the model is prepared once, only the port changes.
+    vle::manager::PreparedSimulation prepared(
+      ctx, std::make_unique<vle::vpz::Vpz>(vpz));
+    {
+        vle::manager::Error error;
+        prepared.prepare(&error);
+        EnsuresEqual(error.code, 0);
+    }
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i != simulations; ++i) {
+        prepared.setConditionPort(
+          "cond", "value", vle::value::Double::create(i));
+
+        vle::manager::Error error;
+        auto result = prepared.run(&error);
+        EnsuresEqual(error.code, 0);
+        if (not result)
+            return;
+
+        EnsuresEqual(vle::value::toDouble(result->getMatrix("view1")(1, 10)),
+                     reference[i]);
+    }
+    std::chrono::duration<double> once = std::chrono::steady_clock::now() -
+                                         start;
+
+    std::printf("%d simulations: %f s (copy), %f s (prepared)\n",
+                simulations,
+                copy.count(),
+                once.count());
+
+    EnsuresThrow(prepared.setConditionPort(
+                   "unknown", "value", vle::value::Double::create(0)),
+                 vle::utils::ArgError);
+}
+
+/**
+ * A simulation server command which exits without serving is tried once:
+ * the next simulations of the same @c Simulation do not start it again.
+ */
+void
+test_server_failure()
+{
+#ifndef _WIN32
+    using namespace std::chrono_literals;
+
+    vle::utils::Path::current_path(vle::utils::Path(MANAGER_TEST_DIR));
+
+    auto ctx = make_context();
+    vle::utils::UnlinkPath attempts(
+      vle::utils::Path::temp_directory_path() /
+      vle::utils::Path::unique_path("vle-server-%%%%-%%%%.txt"));
+
+    Ensures(ctx->set_setting(
+      "vle.command.vle.server",
+      std::string("sh -c \"echo start >> ") + attempts.string() + "\" %1%"));
+    Ensures(ctx->set_setting("vle.command.vle.simulation",
+                             std::string("false %1% %2%")));
+
+    vle::vpz::Vpz vpz(MANAGER_TEST_DIR "/manager.vpz");
+    vle::manager::Simulation sim(
+      ctx, vle::manager::SIMULATION_SPAWN_PROCESS, 0ms);
+
+    for (int i = 0; i != 3; ++i) {
+        vle::manager::Error error;
+        sim.run(std::make_unique<vle::vpz::Vpz>(vpz), &error);
+    }
+
+    std::ifstream ifs(attempts.string());
+    std::string line;
+    int lines = 0;
+    while (std::getline(ifs, line))
+        ++lines;
+
+    EnsuresEqual(lines, 1);
+#endif
+}
+
+int
+main()
+{
+    test_run_plan_output();
+    test_integration_in_simulation();
+    test_expected_duration();
+    test_prepared_simulation();
+    test_server_failure();
+
+    return unit_test::report_errors();
+}
@@ -18,12 +18,24 @@
 
 #include <vle/utils/unit-test.hpp>
 
+#include <random>
 #include <stdexcept>
 #include <limits>
 #include <fstream>
 #include <iostream>
 
+#include <vle/manager/Manager.hpp>
+#include <vle/utils/Rand.hpp>
+#include <vle/utils/Tools.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/Tuple.hpp>
+
 #include "details/accu_mono.hpp"
+#include "details/wrapper_init.hpp"
+#include "details/manager_concepts.hpp"
+#include "details/integration_plugin.hpp"
 
 //Accumulators
 void test_accumulators()
@@ -67,9 +79,377 @@ void test_accumulators()
     }
 }
 
+void test_accumulators_merge()
+{
+    namespace vm = vle::manager;
+    const double values[] = {1, 5, 4, 3.6, 8, 3, 2};
+    for (vm::AccuType type : {vm::STANDARD, vm::QUANTILE}) {
+        vm::AccuMono all(type);
+        vm::AccuMono first(type);
+        vm::AccuMono second(type);
+        for (unsigned int i=0; i < 7; i++) {
+            all.insert(values[i]);
+            if (i % 2) {
+                first.insert(values[i]);
+            } else {
+                second.insert(values[i]);
+            }
+        }
+        first.merge(second);
+        EnsuresEqual(first.count(), all.count());
+        EnsuresApproximatelyEqual(first.mean(), all.mean(), 10e-8);
+        if (type == vm::STANDARD) {
+            EnsuresApproximatelyEqual(first.variance(), all.variance(),
+                    10e-8);
+            EnsuresApproximatelyEqual(first.max(), all.max(), 10e-8);
+        } else {
+            EnsuresApproximatelyEqual(first.quantile(0.25),
+                    all.quantile(0.25), 10e-8);
+        }
+    }
+    {
+        vm::AccuMono acc(vm::STANDARD);
+        EnsuresThrow(acc.merge(vm::AccuMono(vm::QUANTILE)),
+                vle::utils::ArgError);
+    }
+}
+
+//rank error of the quantile sketch against the exact quantiles
+void test_quantile_sketch()
+{
+    namespace vm = vle::manager;
+    const unsigned int n = 100000;
+    std::mt19937 gen(12365);
+    std::lognormal_distribution<double> distribution(0.0, 1.0);
+
+    vm::AccuMono exact(vm::QUANTILE);
+    vm::AccuMono sketch(vm::S_quantile, true);
+    std::vector<vm::AccuMono> parts(4, vm::AccuMono(vm::S_quantile, true));
+    vm::QuantileSketch alone;
+    std::vector<double> sorted;
+    for (unsigned int i=0; i < n; i++) {
+        double v = distribution(gen);
+        exact.insert(v);
+        sketch.insert(v);
+        parts[i % 4].insert(v);
+        alone.insert(v);
+        sorted.push_back(v);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    for (unsigned int k=1; k < 4; k++) {
+        parts[0].merge(parts[k]);
+    }
+
+    EnsuresEqual(sketch.count(), n);
+    EnsuresEqual(parts[0].count(), n);
+    EnsuresApproximatelyEqual(sketch.mean(), exact.mean(), 10e-8);
+    EnsuresEqual(sketch.min(), sorted.front());
+    EnsuresEqual(sketch.max(), sorted.back());
+    Ensures(alone.size() <= 200);
+
+    for (double q : {0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999}) {
+        double bound = M_PI * std::sqrt(q * (1 - q)) / 200 + 1.0 / n;
+        for (vm::AccuMono* acc : {&sketch, &parts[0]}) {
+            double estimate = acc->quantile(q);
+            double rank = (std::lower_bound(sorted.begin(), sorted.end(),
+                    estimate) - sorted.begin()) / (double) n;
+            Ensures(std::abs(rank - q) <= bound);
+        }
+        EnsuresApproximatelyEqual(sketch.quantile(q), exact.quantile(q),
+                0.02);
+    }
+}
+
+//one simulation result: a view with the header in the first row
+static std::unique_ptr<vle::value::Matrix>
+make_view(unsigned int input, unsigned int replicate)
+{
+    std::unique_ptr<vle::value::Matrix> view(
+            new vle::value::Matrix(2, 4, 10, 10));
+    view->set(0, 0, vle::value::String::create("time"));
+    view->set(1, 0, vle::value::String::create("top:model.port"));
+    for (unsigned int t=1; t < 4; t++) {
+        view->set(0, t, vle::value::Double::create(t));
+        view->set(1, t, vle::value::Double::create(
+                input + 0.3 * replicate * replicate + t));
+    }
+    return view;
+}
+
+//the same simulation result from the columnar storage plug-in
+static std::unique_ptr<vle::value::Matrix>
+make_columnar_view(unsigned int input, unsigned int replicate)
+{
+    std::unique_ptr<vle::value::Matrix> view(
+            new vle::value::Matrix(2, 2, 10, 10));
+    view->set(0, 0, vle::value::String::create("time"));
+    view->set(1, 0, vle::value::String::create("top:model.port"));
+    std::unique_ptr<vle::value::Tuple> times(new vle::value::Tuple(3));
+    std::unique_ptr<vle::value::Tuple> values(new vle::value::Tuple(3));
+    for (unsigned int t=1; t < 4; t++) {
+        times->at(t - 1) = t;
+        values->at(t - 1) = input + 0.3 * replicate * replicate + t;
+    }
+    view->set(0, 1, std::move(times));
+    view->set(1, 1, std::move(values));
+    return view;
+}
+
+static void
+check_equal(const vle::value::Value& a, const vle::value::Value& b)
+{
+    if (a.isDouble()) {
+        Ensures(b.isDouble());
+        EnsuresApproximatelyEqual(a.toDouble().value(),
+                b.toDouble().value(), 10e-8);
+    } else {
+        const vle::value::Table& ta = a.toTable();
+        const vle::value::Table& tb = b.toTable();
+        EnsuresEqual(ta.width(), tb.width());
+        EnsuresEqual(ta.height(), tb.height());
+        for (unsigned int i=0; i < ta.width(); i++) {
+            for (unsigned int j=0; j < ta.height(); j++) {
+                EnsuresApproximatelyEqual(ta.get(i, j), tb.get(i, j), 10e-8);
+            }
+        }
+    }
+}
+
+//aggregations of outputs split between threads then merged
+void test_outputs_merge()
+{
+    namespace vm = vle::manager;
+    const unsigned int N = 6;
+    const unsigned int M = 4;
+    const char* configs[][3] = {
+        {"last", "mean", "mean"},
+        {"max", "variance", "max"},
+        {"sum", "quantile", "quantile"},
+        {"last", "variance", "all"},
+        {"all", "mean", "mean"},
+        {"all", "quantile", "all"}};
+
+    for (const auto& conf : configs) {
+        vle::value::Map config;
+        config.addString("path", "view/top:model.port");
+        config.addString("integration", conf[0]);
+        config.addString("aggregation_replicate", conf[1]);
+        config.addString("aggregation_input", conf[2]);
+
+        vm::ManOutput reference("out", config);
+        std::vector<std::unique_ptr<vm::ManOutput>> outputs;
+        for (unsigned int k=0; k < 3; k++) {
+            outputs.emplace_back(reference.clone());
+        }
+
+        std::unique_ptr<vle::value::Value> expected;
+        std::unique_ptr<vle::value::Value> merged;
+        for (unsigned int i=0; i < N*M; i++) {
+            std::unique_ptr<vle::value::Matrix> view = make_view(i/M, i%M);
+            std::unique_ptr<vle::value::Value> res =
+                    reference.insertReplicate(*view, i/M, N, M);
+            if (res) {
+                expected = std::move(res);
+            }
+            view = make_view(i/M, i%M);
+            Ensures(not outputs[i % 3]->insertReplicate(*view, i/M, N, M));
+        }
+        for (unsigned int k=1; k < 3; k++) {
+            std::unique_ptr<vle::value::Value> res =
+                    outputs[0]->merge(*outputs[k]);
+            if (res) {
+                Ensures(k == 2);
+                merged = std::move(res);
+            }
+        }
+        Ensures(expected);
+        Ensures(merged);
+        if (expected and merged) {
+            check_equal(*expected, *merged);
+        }
+    }
+}
+
+//the aggregations of the columnar views are the ones of the matrix views
+void test_outputs_columnar()
+{
+    namespace vm = vle::manager;
+    const unsigned int N = 3;
+    const unsigned int M = 2;
+    const char* configs[][3] = {
+        {"last", "mean", "mean"},
+        {"max", "mean", "all"},
+        {"sum", "quantile", "quantile"},
+        {"all", "mean", "mean"},
+        {"all", "mean", "all"}};
+
+    for (const auto& conf : configs) {
+        vle::value::Map config;
+        config.addString("path", "view/top:model.port");
+        config.addString("integration", conf[0]);
+        config.addString("aggregation_replicate", conf[1]);
+        config.addString("aggregation_input", conf[2]);
+
+        vm::ManOutput reference("out", config);
+        vm::ManOutput columnar("out", config);
+        std::unique_ptr<vle::value::Value> expected;
+        std::unique_ptr<vle::value::Value> result;
+        for (unsigned int i=0; i < N*M; i++) {
+            std::unique_ptr<vle::value::Matrix> view = make_view(i/M, i%M);
+            std::unique_ptr<vle::value::Value> res =
+                    reference.insertReplicate(*view, i/M, N, M);
+            if (res) {
+                expected = std::move(res);
+            }
+            view = make_columnar_view(i/M, i%M);
+            Ensures(columnar.columnar(*view));
+            res = columnar.insertReplicate(*view, i/M, N, M);
+            if (res) {
+                result = std::move(res);
+            }
+        }
+        Ensures(expected);
+        Ensures(result);
+        if (expected and result) {
+            check_equal(*expected, *result);
+        }
+    }
+}
+
+//an observation of a view: the date, the column (0 for top:model.port,
+//1 for top:other.port) and the value
+struct Observation
+{
+    double time;
+    unsigned int column;
+    double value;
+    const char* string;//the value is a string if not null
+};
+
+static std::unique_ptr<vle::value::Value>
+observed(const Observation& o)
+{
+    if (o.string) {
+        return vle::value::String::create(o.string);
+    }
+    return vle::value::Double::create(o.value);
+}
+
+//the view built by the storage plug-in: a row for each date
+static std::unique_ptr<vle::value::Matrix>
+make_storage_view(const std::vector<Observation>& obs)
+{
+    std::unique_ptr<vle::value::Matrix> view(
+            new vle::value::Matrix(3, 1, 10, 10));
+    view->set(0, 0, vle::value::String::create("time"));
+    view->set(1, 0, vle::value::String::create("top:model.port"));
+    view->set(2, 0, vle::value::String::create("top:other.port"));
+    for (unsigned int i=0; i < obs.size(); i++) {
+        if (i == 0 or obs[i].time != obs[i - 1].time) {
+            view->addRow();
+            view->set(0, view->rows() - 1,
+                    vle::value::Double::create(obs[i].time));
+        }
+        view->set(obs[i].column + 1, view->rows() - 1, observed(obs[i]));
+    }
+    return view;
+}
+
+//the view built by the integration plug-in, reals through onHandleReal
+static std::unique_ptr<vle::value::Matrix>
+make_integrated_view(const std::vector<Observation>& obs,
+        vle::manager::ManOutput& output)
+{
+    vle::manager::IntegrationPlugin plugin("");
+    plugin.onParameter("", "", "",
+            vle::manager::IntegrationPlugin::parameters({&output}), 0);
+    plugin.onNewObservableHandle("model", "top", "port", "view", 0);
+    plugin.onNewObservableHandle("other", "top", "port", "view", 0);
+    for (const Observation& o : obs) {
+        if (o.string) {
+            plugin.onHandleValue(o.column, o.time, observed(o));
+        } else {
+            plugin.onHandleReal(o.column, o.time, o.value);
+        }
+    }
+    return plugin.finish(0);
+}
+
+//the integration plug-in gives the results of the storage matrix
+void test_outputs_integrated()
+{
+    namespace vm = vle::manager;
+    //two values of the model at the date 2: the last one is kept
+    const std::vector<Observation> dense = {
+        {0, 0, 1.0, nullptr}, {0, 1, 7.0, nullptr},
+        {1, 0, 4.0, nullptr}, {1, 1, 7.0, nullptr},
+        {2, 0, 100.0, nullptr}, {2, 1, 7.0, nullptr}, {2, 0, 3.0, nullptr},
+        {3, 0, 2.0, nullptr}, {3, 1, 7.0, nullptr}};
+    //no value of the model at the date 2 (last date)
+    const std::vector<Observation> sparse = {
+        {0, 0, 1.0, nullptr}, {1, 0, 4.0, nullptr}, {2, 1, 7.0, nullptr}};
+    //a value of the model is not a double
+    const std::vector<Observation> strings = {
+        {0, 0, 1.0, nullptr}, {1, 0, 0.0, "a"}, {2, 0, 3.0, nullptr}};
+
+    for (const char* integration : {"last", "max", "sum", "mse"}) {
+        vle::value::Map config;
+        config.addString("path", "view/top:model.port");
+        config.addString("integration", integration);
+        config.addString("aggregation_input", "all");
+        if (std::string(integration) == "mse") {
+            std::unique_ptr<vle::value::Tuple> times(new vle::value::Tuple(3));
+            times->at(0) = 1;
+            times->at(1) = 2;
+            times->at(2) = 9;//after the end: ignored
+            config.add("mse_times", std::move(times));
+            config.add("mse_observations", std::unique_ptr<vle::value::Tuple>(
+                    new vle::value::Tuple(3, 1.0)));
+        }
+
+        vm::ManOutput reference("out", config);
+        vm::ManOutput integrated("out", config);
+        integrated.integrated = true;
+        std::unique_ptr<vle::value::Matrix> view = make_storage_view(dense);
+        std::unique_ptr<vle::value::Value> expected =
+                reference.insertReplicate(*view, 0, 1, 1);
+        view = make_integrated_view(dense, integrated);
+        std::unique_ptr<vle::value::Value> result =
+                integrated.insertReplicate(*view, 0, 1, 1);
+        Ensures(expected);
+        Ensures(result);
+        if (expected and result) {
+            check_equal(*expected, *result);
+        }
+
+        //the matrix integration fails where a row has no double value,
+        //'last' has no value (the cell of the last row is empty)
+        for (const auto* obs : {&sparse, &strings}) {
+            vm::ManOutput out("out", config);
+            out.integrated = true;
+            view = make_integrated_view(*obs, out);
+            if (std::string(integration) == "last") {
+                Ensures(view->get(0, 1)->isNull() == (obs == &sparse));
+                continue;
+            }
+            EnsuresThrow(out.insertReplicate(*view, 0, 1, 1),
+                    vle::utils::ArgError);
+            vm::ManOutput ref("out", config);
+            view = make_storage_view(*obs);
+            EnsuresThrow(ref.insertReplicate(*view, 0, 1, 1),
+                    std::exception);
+        }
+    }
+}
+
 int main()
 {
     test_accumulators();
+    test_accumulators_merge();
+    test_quantile_sketch();
+    test_outputs_merge();
+    test_outputs_columnar();
+    test_outputs_integrated();
 
     return unit_test::report_errors();
 }
@@ -0,0 +1,298 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Filesystem.hpp>
+#include <vle/utils/unit-test.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/User.hpp>
+
+#include "File.hpp"
+
+using namespace vle;
+
+/**
+ * An output of the file plug-in in the temporary directory, removed at
+ * the end of the test.
+ */
+struct Output
+{
+    Output(const std::string& type,
+           const std::string& extension,
+           bool asynchronous = true)
+      : location(utils::Path::temp_directory_path().string())
+      , file(utils::Path::unique_path("vle-output-%%%%-%%%%").string())
+      , unlink(utils::Path(location) / (file + extension))
+      , plugin(location)
+    {
+        auto parameters = value::Map::create();
+        parameters->toMap().addString("type", type);
+        parameters->toMap().addBoolean("asynchronous", asynchronous);
+        plugin.onParameter("file", location, file, std::move(parameters), 0);
+    }
+
+    std::int32_t observable(const std::string& name, double time)
+    {
+        return plugin.onNewObservableHandle(name, "top", "p", "view", time);
+    }
+
+    std::string content() const
+    {
+        std::ifstream ifs(unlink.string(), std::ios::binary);
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        return oss.str();
+    }
+
+    std::string location;
+    std::string file;
+    utils::UnlinkPath unlink;
+    oov::plugin::File plugin;
+};
+
+/**
+ * A value which cannot be written, to make the writer fail.
+ */
+class Unwritable : public value::User
+{
+public:
+    size_t id() const override
+    {
+        return 0u;
+    }
+
+    std::unique_ptr<value::Value> clone() const override
+    {
+        return std::unique_ptr<value::Value>(new Unwritable(*this));
+    }
+
+    void writeFile(std::ostream& /*out*/) const override
+    {
+        throw utils::InternalError("unwritable value");
+    }
+
+    void writeString(std::ostream& out) const override
+    {
+        out << "unwritable";
+    }
+
+    void writeXml(std::ostream& out) const override
+    {
+        out << "<null />";
+    }
+};
+
+/**
+ * A value which is slow to write, to fill the queue of the writer.
+ */
+class Slow : public value::User
+{
+public:
+    size_t id() const override
+    {
+        return 1u;
+    }
+
+    std::unique_ptr<value::Value> clone() const override
+    {
+        return std::unique_ptr<value::Value>(new Slow(*this));
+    }
+
+    void writeFile(std::ostream& out) const override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        out << "slow";
+    }
+
+    void writeString(std::ostream& out) const override
+    {
+        out << "slow";
+    }
+
+    void writeXml(std::ostream& out) const override
+    {
+        out << "<null />";
+    }
+};
+
+/**
+ * Split the @e content of an output into the header line, without the
+ * end of line, and the rows.
+ */
+static void
+split(const std::string& content, std::string& head, std::string& rows)
+{
+    auto width = content.find('\n') + 1;
+    head = content.substr(0, width - 1);
+    rows = content.substr(width);
+}
+
+void
+test_single_pass()
+{
+    Output output("csv", ".csv");
+    auto a = output.observable("a", 0);
+    auto b = output.observable("b", 0);
+
+    output.plugin.onHandleReal(a, 0, 1);
+    output.plugin.onHandleValue(b, 0, value::Double::create(2));
+    output.plugin.onHandleReal(a, 1, 3);
+    output.plugin.onHandleValue(b, 1, value::Double::create(4));
+    output.plugin.finish(2);
+
+    std::string head, rows;
+    split(output.content(), head, rows);
+
+    EnsuresEqual(head, "time;\"top:a.p\";\"top:b.p\"");
+    EnsuresEqual(rows, "0;1;2\n1;3;4\n\n\n");
+}
+
+void
+test_late_column()
+{
+    Output output("csv", ".csv");
+    auto a = output.observable("a", 0);
+
+    output.plugin.onHandleReal(a, 0, 1);
+    output.plugin.onHandleReal(a, 1, 2);
+    auto b = output.observable("b", 1.5);
+    output.plugin.onHandleReal(a, 2, 3);
+    output.plugin.onHandleReal(b, 2, 4);
+    output.plugin.finish(3);
+
+    std::string head, rows;
+    split(output.content(), head, rows);
+
+    // The rows written before the observable b keep their cells and the
+    // header lists all the observables.
+    EnsuresEqual(head, "time;\"top:a.p\";\"top:b.p\"");
+    EnsuresEqual(rows, "0;1\n1;2\n2;3;4\n\n\n");
+}
+
+void
+test_late_column_text()
+{
+    Output output("text", ".dat");
+    auto a = output.observable("a", 0);
+    output.plugin.onHandleReal(a, 0, 1);
+
+    auto b = output.observable("b", 1);
+    output.plugin.onHandleReal(a, 1, 2);
+    output.plugin.onHandleReal(b, 1, 3);
+    output.plugin.finish(2);
+
+    std::string head, rows;
+    split(output.content(), head, rows);
+
+    EnsuresEqual(head, "#\"time\"\t\"top:a.p\"\t\"top:b.p\"\t");
+    EnsuresEqual(rows, "0\t1\n1\t2\t3\n\n\n");
+}
+
+/**
+ * Write more rows than the size of the queue with and without the writer
+ * thread: the simulation waits for the writer when the queue is full and
+ * the outputs are the same when finish returns.
+ */
+void
+test_writer_queue_full()
+{
+    const std::size_t rows = 4 * oov::plugin::File::queue_size;
+    Output synchronous("csv", ".csv", false);
+    Output asynchronous("csv", ".csv", true);
+
+    for (auto* output : { &synchronous, &asynchronous }) {
+        auto a = output->observable("a", 0);
+        auto b = output->observable("b", 0);
+
+        // The first row stops the writer while the queue is filled.
+        output->plugin.onHandleReal(a, 0, 0);
+        output->plugin.onHandleValue(b, 0, std::make_unique<Slow>());
+
+        for (std::size_t i = 1; i < rows; ++i) {
+            output->plugin.onHandleReal(a, i, i);
+            output->plugin.onHandleValue(b, i, value::Double::create(2 * i));
+        }
+
+        output->plugin.finish(rows);
+    }
+
+    std::string head, content;
+    split(asynchronous.content(), head, content);
+
+    EnsuresEqual(asynchronous.content(), synchronous.content());
+    EnsuresEqual(std::count(content.begin(), content.end(), '\n'),
+                 static_cast<std::ptrdiff_t>(rows + 2));
+
+    std::ostringstream last;
+    last << '\n' << rows - 1 << ';' << rows - 1 << ';' << 2 * (rows - 1)
+         << "\n\n\n";
+    Ensures(content.size() > last.str().size() and
+            content.compare(content.size() - last.str().size(),
+                            last.str().size(),
+                            last.str()) == 0);
+}
+
+/**
+ * The exception of the writer is thrown by finish and the simulation
+ * never waits for a failed writer.
+ */
+void
+test_writer_exception()
+{
+    const std::size_t rows = 4 * oov::plugin::File::queue_size;
+    Output output("csv", ".csv");
+    auto a = output.observable("a", 0);
+
+    output.plugin.onHandleValue(a, 0, std::make_unique<Unwritable>());
+
+    try {
+        for (std::size_t i = 1; i < rows; ++i)
+            output.plugin.onHandleReal(a, i, i);
+    } catch (const utils::InternalError& /*e*/) {
+    }
+
+    EnsuresThrow(output.plugin.finish(rows), utils::InternalError);
+}
+
+int
+main()
+{
+    test_single_pass();
+    test_late_column();
+    test_late_column_text();
+    test_writer_queue_full();
+    test_writer_exception();
+
+    return unit_test::report_errors();
+}
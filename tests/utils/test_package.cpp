@@ -481,12 +481,95 @@ test_compress_filepath(vle::utils::ContextPtr ctx)
     Ensures(t2.exists());
 }
 
+void
+test_spawn_wait(vle::utils::ContextPtr ctx)
+{
+#ifndef _WIN32
+    {
+        vle::utils::Spawn spawn(ctx);
+        Ensures(spawn.start("/bin/sh",
+                            utils::Path::temp_directory_path(),
+                            { "-c", "echo out; echo err >&2; exit 3" },
+                            std::chrono::milliseconds::zero()));
+
+        std::string output, error, message;
+        bool success = true;
+        Ensures(spawn.wait(&output, &error, std::chrono::milliseconds::zero()));
+        Ensures(spawn.isfinish());
+        EnsuresEqual(output, "out\n");
+        EnsuresEqual(error, "err\n");
+        spawn.status(&message, &success);
+        Ensures(not success);
+    }
+
+    {
+        vle::utils::Spawn spawn(ctx);
+        Ensures(spawn.start("/bin/sh",
+                            utils::Path::temp_directory_path(),
+                            { "-c", "sleep 10" },
+                            std::chrono::milliseconds::zero()));
+
+        auto start = std::chrono::steady_clock::now();
+        Ensures(
+          not spawn.wait(nullptr, nullptr, std::chrono::milliseconds(100)));
+        Ensures(std::chrono::steady_clock::now() - start <
+                std::chrono::seconds(5));
+        Ensures(spawn.isfinish());
+    }
+
+    {
+        // The sub-process closes its outputs and keeps running: the
+        // timeout still kills it.
+        vle::utils::Spawn spawn(ctx);
+        Ensures(spawn.start("/bin/sh",
+                            utils::Path::temp_directory_path(),
+                            { "-c", "exec >&- 2>&-; sleep 10" },
+                            std::chrono::milliseconds::zero()));
+
+        auto start = std::chrono::steady_clock::now();
+        Ensures(
+          not spawn.wait(nullptr, nullptr, std::chrono::milliseconds(100)));
+        Ensures(std::chrono::steady_clock::now() - start <
+                std::chrono::seconds(5));
+        Ensures(spawn.isfinish());
+    }
+
+    {
+        // The reader receives the first line before the end of the
+        // sub-process.
+        vle::utils::Spawn spawn(ctx);
+        Ensures(spawn.start("/bin/sh",
+                            utils::Path::temp_directory_path(),
+                            { "-c", "echo first; sleep 1; echo last" },
+                            std::chrono::milliseconds::zero()));
+
+        std::string output;
+        int calls = 0;
+        auto start = std::chrono::steady_clock::now();
+        Ensures(spawn.wait(
+          [&](const std::string& out, const std::string& /*err*/) {
+              if (calls++ == 0) {
+                  EnsuresEqual(out, "first\n");
+                  Ensures(std::chrono::steady_clock::now() - start <
+                          std::chrono::milliseconds(900));
+              }
+              output += out;
+          },
+          std::chrono::milliseconds::zero()));
+        EnsuresEqual(output, "first\nlast\n");
+        Ensures(calls >= 2);
+    }
+#endif
+}
+
 int
 main()
 {
     F fixture;
     auto ctx = vle::utils::make_context();
 
+    test_spawn_wait(ctx);
+
     // We check if user use make install or not otherwise, configure(),
     // build() and install() will fail.
 
@@ -34,6 +34,7 @@
 
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/unit-test.hpp>
+#include <vle/value/Binary.hpp>
 #include <vle/value/Boolean.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
@@ -395,6 +396,64 @@ test_table()
     Ensures(t(0, 2) == 4.);
 }
 
+void
+test_binary()
+{
+    value::Map map;
+    map.addBoolean("boolean", true);
+    map.addInt("integer", -12);
+    map.addDouble("double", 0.1);
+    map.addString("string", "a string\nwith two lines");
+    map.add("xml", value::Xml::create("<a/>"));
+    map.add("null", value::Null::create());
+
+    auto& set = map.addSet("set");
+    set.add(value::Integer::create(1));
+    set.add(value::Tuple::create(3, 2.5));
+    set.add(value::Map::create());
+
+    auto& table = map.addTable("table", 2, 3);
+    {
+        double value = 0;
+        for (auto& v : table.value())
+            v = value++;
+    }
+
+    auto& matrix = map.addMatrix("matrix");
+    matrix.resize(3, 4);
+    matrix.set(0, 0, value::String::create("time"));
+    matrix.set(1, 0, value::String::create("top:a.x"));
+    for (std::size_t r = 1; r != 4; ++r) {
+        matrix.set(0, r, value::Double::create(r));
+        matrix.set(1, r, value::Double::create(1.0 / r));
+        matrix.set(2, r, value::Integer::create(static_cast<int>(r)));
+    }
+    matrix.set(1, 2, value::Null::create());
+
+    std::string buffer;
+    value::writeBinary(map, buffer);
+    Ensures(value::isBinary(buffer.data(), buffer.size()));
+
+    auto copy = value::readBinary(buffer.data(), buffer.size());
+    Ensures(copy->isMap());
+    EnsuresEqual(copy->toMap().size(), map.size());
+    for (const auto& elem : map)
+        EnsuresEqual(copy->toMap().get(elem.first)->writeToString(),
+                     elem.second->writeToString());
+    EnsuresEqual(copy->toMap().getTable("table")(1, 2), 5.);
+    EnsuresEqual(copy->toMap().getMatrix("matrix").getDouble(1, 3),
+                 1.0 / 3.0);
+    Ensures(not copy->toMap().getMatrix("matrix").get(2, 0));
+
+    EnsuresThrow(value::readBinary(buffer.data(), buffer.size() - 1),
+                 utils::ArgError);
+    Ensures(not value::isBinary("<?xml", 5));
+
+    std::string user_buffer;
+    test::MyData data(1., 2., 3., "test-vle");
+    EnsuresThrow(value::writeBinary(data, user_buffer), utils::ArgError);
+}
+
 int
 main()
 {
@@ -407,6 +466,7 @@ main()
     test_user_value();
     test_tuple();
     test_table();
+    test_binary();
 
     return unit_test::report_errors();
 }